@@ -0,0 +1,78 @@
+#pragma once
+
+// Counts heap allocations by interposing glibc's malloc entry points,
+// which the plain operator new goes through as well; the over-aligned
+// operator new forms are replaced here too. Include from exactly one
+// translation unit of a benchmark executable. Elsewhere the counter
+// stays at zero and benchmarks print it as unavailable.
+
+#include <cstddef>
+#include <cstdlib>
+#include <new>
+
+namespace bench {
+
+inline long long allocations = 0;  // malloc/calloc/realloc calls so far
+
+// whether allocations is being maintained on this platform
+inline constexpr bool counting_allocations =
+#if defined(__GLIBC__)
+    true;
+#else
+    false;
+#endif
+
+} // namespace bench
+
+#if defined(__GLIBC__)
+extern "C" {
+void* __libc_malloc(std::size_t size);
+void* __libc_calloc(std::size_t count, std::size_t size);
+void* __libc_realloc(void* p, std::size_t size);
+
+void* malloc(std::size_t size) noexcept {
+    bench::allocations++;
+    return __libc_malloc(size);
+}
+
+void* calloc(std::size_t count, std::size_t size) noexcept {
+    bench::allocations++;
+    return __libc_calloc(count, size);
+}
+
+void* realloc(void* p, std::size_t size) noexcept {
+    bench::allocations++;
+    return __libc_realloc(p, size);
+}
+}
+
+void* operator new(std::size_t size, std::align_val_t align) {
+    std::size_t a = static_cast<std::size_t>(align);
+    void* p = std::aligned_alloc(a, (size + a - 1) / a * a);
+    if (p == nullptr) {
+        throw std::bad_alloc();
+    }
+    bench::allocations++;
+    return p;
+}
+
+void* operator new[](std::size_t size, std::align_val_t align) {
+    return operator new(size, align);
+}
+
+void operator delete(void* p, std::align_val_t) noexcept {
+    std::free(p);
+}
+
+void operator delete(void* p, std::size_t, std::align_val_t) noexcept {
+    std::free(p);
+}
+
+void operator delete[](void* p, std::align_val_t) noexcept {
+    std::free(p);
+}
+
+void operator delete[](void* p, std::size_t, std::align_val_t) noexcept {
+    std::free(p);
+}
+#endif
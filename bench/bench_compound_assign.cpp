@@ -0,0 +1,44 @@
+// The accumulation step of an iterative solver, 1000 times over a
+// 1024x1024 float matrix: m = m + x (the only spelling before +=, one new
+// Matrix per step), m += x in place, and m += alpha * x fused.
+// GB/s counts the buffers each step reads and writes once.
+
+#include "alloc_counter.hpp"
+#include "bench_util.hpp"
+#include "matrix.hpp"
+
+#include <cstdio>
+
+namespace {
+
+constexpr int N = 1024;
+constexpr int STEPS = 1000;
+using M = dsa::Matrix<float>;
+
+template <typename Fn>
+void run(const char* label, int passes, Fn step) {
+    M m(N, N);
+    M x(N, N);
+    x(1, 1) = 1.0f;
+    long long before = bench::allocations;
+    bench::Timer t;
+    for (int s = 0; s < STEPS; s++) {
+        step(m, x);
+    }
+    double ms = t.ms();
+    bench::do_not_optimize(m(1, 1));
+    double bytes = double(passes) * N * N * sizeof(float) * STEPS;
+    std::printf("%-32s %10.3f ms %8.2f GB/s %8lld mallocs\n", label, ms,
+                bytes / 1e9 / (ms / 1e3), bench::allocations - before);
+}
+
+} // namespace
+
+int main() {
+    std::printf("%d threads\n", dsa::parallel::threads());
+    run("m = M(m + x)", 3, [](M& m, M& x) { m = M(m + x); });
+    run("m += x", 3, [](M& m, M& x) { m += x; });
+    run("m += 0.5f * x", 3, [](M& m, M& x) { m += 0.5f * x; });
+    run("m *= 0.999f", 2, [](M& m, M&) { m *= 0.999f; });
+    return 0;
+}
@@ -0,0 +1,77 @@
+// Sums of 2, 4 and 8 4096x4096 float matrices, evaluated eagerly (one
+// temporary Matrix per +, the previous operator+) against the fused
+// expression-template loop. "traffic" is the memory the loop has to move:
+// eager (L-1) passes of 2 reads + 1 write, fused L reads + 1 write.
+
+#include "alloc_counter.hpp"
+#include "bench_util.hpp"
+#include "matrix.hpp"
+
+#include <cstdio>
+#include <vector>
+
+namespace {
+
+constexpr int N = 4096;
+using M = dsa::Matrix<float>;
+
+void report(const char* label, double ms, double bytes, long long allocs) {
+    std::printf("%-32s %10.3f ms %8.0f MiB traffic %8.2f GB/s %4lld mallocs\n",
+                label, ms, bytes / (1 << 20), bytes / 1e9 / (ms / 1e3), allocs);
+}
+
+// acc = a0 + a1, acc = acc + a2, ... each step a new Matrix
+M eager(std::vector<M>& in, std::size_t len) {
+    M acc = M(in[0] + in[1]);
+    for (std::size_t i = 2; i < len; i++) {
+        acc = M(acc + in[i]);
+    }
+    return acc;
+}
+
+M fused(std::vector<M>& in, std::size_t len) {
+    if (len == 2) {
+        return in[0] + in[1];
+    }
+    if (len == 4) {
+        return in[0] + in[1] + in[2] + in[3];
+    }
+    return in[0] + in[1] + in[2] + in[3] + in[4] + in[5] + in[6] + in[7];
+}
+
+template <typename Fn>
+void run(const char* label, Fn fn, std::vector<M>& in, std::size_t len, double bytes) {
+    fn(in, len);  // warm-up
+    double best = 1e300;
+    long long allocs = 0;
+    for (int rep = 0; rep < 3; rep++) {
+        long long before = bench::allocations;
+        bench::Timer t;
+        M r = fn(in, len);
+        double ms = t.ms();
+        bench::do_not_optimize(r(N - 1, N - 1));
+        allocs = bench::allocations - before;
+        best = ms < best ? ms : best;
+    }
+    report(label, best, bytes, allocs);
+}
+
+} // namespace
+
+int main() {
+    std::vector<M> in;
+    for (int m = 0; m < 8; m++) {
+        in.emplace_back(N, N);
+        in.back()(m, m) = float(m);
+    }
+    double mat = double(N) * N * sizeof(float);
+    std::printf("%d threads\n", dsa::parallel::threads());
+    for (std::size_t len : {2, 4, 8}) {
+        char label[64];
+        std::snprintf(label, sizeof(label), "%zu-term sum, eager", len);
+        run(label, eager, in, len, double(len - 1) * 3 * mat);
+        std::snprintf(label, sizeof(label), "%zu-term sum, fused", len);
+        run(label, fused, in, len, double(len + 1) * mat);
+    }
+    return 0;
+}
@@ -0,0 +1,154 @@
+// Square matrix products: dsa::Matrix operator* (packed, cache-blocked,
+// SIMD micro-kernels) against a straightforward i-k-j triple loop, for
+// float and double. GFLOP/s counts 2*n^3 flops; "% peak" is relative to
+// one core's FMA throughput, measured below for the dispatched ISA, or
+// given on the command line:
+//     bench_gemm [peak_gflops_double]
+// (the float peak is taken as twice the double one)
+
+#include "bench_util.hpp"
+#include "gemm.hpp"
+#include "matrix.hpp"
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+#if defined(__x86_64__) && defined(__GNUC__)
+#include <immintrin.h>
+#endif
+
+namespace {
+
+// the textbook loop order: streams rows of B and C, no blocking
+template <typename T>
+dsa::Matrix<T> naive_product(dsa::Matrix<T>& a, dsa::Matrix<T>& b, int n) {
+    dsa::Matrix<T> c(n, n);
+    T* out = &c(0, 0);
+    const T* bp = &b(0, 0);
+    for (int i = 0; i < n; i++) {
+        for (int k = 0; k < n; k++) {
+            T aik = a(i, k);
+            for (int j = 0; j < n; j++) {
+                out[i * n + j] += aik * bp[k * n + j];
+            }
+        }
+    }
+    return c;
+}
+
+#if defined(__x86_64__) && defined(__GNUC__)
+// 12 independent FMA chains on L1-resident registers, double precision
+__attribute__((target("avx512f"))) double fma_peak_avx512(long iters) {
+    __m512d acc[12];
+    for (auto& v : acc) v = _mm512_set1_pd(1.0);
+    __m512d x = _mm512_set1_pd(1.0000001), y = _mm512_set1_pd(0.9999999);
+    for (long i = 0; i < iters; i++) {
+#pragma GCC unroll 12
+        for (auto& v : acc) v = _mm512_fmadd_pd(v, x, y);
+    }
+    double sum = 0;
+    for (auto& v : acc) sum += _mm512_reduce_add_pd(v);
+    bench::do_not_optimize(sum);
+    return double(iters) * 12 * 8 * 2;
+}
+
+__attribute__((target("avx2,fma"))) double fma_peak_avx2(long iters) {
+    __m256d acc[12];
+    for (auto& v : acc) v = _mm256_set1_pd(1.0);
+    __m256d x = _mm256_set1_pd(1.0000001), y = _mm256_set1_pd(0.9999999);
+    for (long i = 0; i < iters; i++) {
+#pragma GCC unroll 12
+        for (auto& v : acc) v = _mm256_fmadd_pd(v, x, y);
+    }
+    double sum[4]{};
+    for (auto& v : acc) {
+        double lanes[4];
+        _mm256_storeu_pd(lanes, v);
+        for (int l = 0; l < 4; l++) sum[l] += lanes[l];
+    }
+    bench::do_not_optimize(sum[0] + sum[1] + sum[2] + sum[3]);
+    return double(iters) * 12 * 4 * 2;
+}
+#endif
+
+// double-precision GFLOP/s of one core for the ISA gemm dispatches to
+double measure_peak() {
+    const long iters = 50'000'000;
+    bench::Timer t;
+    double flops = 0;
+#if defined(__x86_64__) && defined(__GNUC__)
+    if (std::strcmp(dsa::detail::gemm_isa(), "avx512") == 0) {
+        flops = fma_peak_avx512(iters);
+    } else if (std::strcmp(dsa::detail::gemm_isa(), "avx2") == 0) {
+        flops = fma_peak_avx2(iters);
+    }
+#endif
+    if (flops == 0) {
+        return 0;
+    }
+    return flops / (t.ms() * 1e6);
+}
+
+template <typename T>
+void fill(dsa::Matrix<T>& m, int n, unsigned seed) {
+    for (int i = 0; i < n; i++) {
+        for (int j = 0; j < n; j++) {
+            seed = seed * 1103515245u + 12345u;
+            m(i, j) = static_cast<T>((seed >> 16) % 1000) / T(1000);
+        }
+    }
+}
+
+template <typename T>
+void run(const char* type, int n, double peak, bool with_naive) {
+    dsa::Matrix<T> a(n, n);
+    dsa::Matrix<T> b(n, n);
+    fill(a, n, 1);
+    fill(b, n, 2);
+    double flops = 2.0 * n * n * n;
+    char label[64];
+
+    // warm-up, then best of three
+    dsa::Matrix<T> c = a * b;
+    double best = 1e300;
+    for (int rep = 0; rep < 3; rep++) {
+        bench::Timer t;
+        dsa::Matrix<T> r = a * b;
+        double ms = t.ms();
+        bench::do_not_optimize(r(n - 1, n - 1));
+        best = ms < best ? ms : best;
+    }
+    double gflops = flops / (best * 1e6);
+    std::snprintf(label, sizeof(label), "%s %dx%d operator*", type, n, n);
+    if (peak > 0) {
+        std::printf("%-40s %10.3f ms %8.1f GFLOP/s %6.1f%% peak\n", label, best, gflops,
+                    100.0 * gflops / peak);
+    } else {
+        std::printf("%-40s %10.3f ms %8.1f GFLOP/s\n", label, best, gflops);
+    }
+
+    if (with_naive) {
+        bench::Timer t;
+        dsa::Matrix<T> r = naive_product(a, b, n);
+        double ms = t.ms();
+        bench::do_not_optimize(r(n - 1, n - 1));
+        std::snprintf(label, sizeof(label), "%s %dx%d naive i-k-j", type, n, n);
+        std::printf("%-40s %10.3f ms %8.1f GFLOP/s\n", label, ms, flops / (ms * 1e6));
+    }
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    double peak64 = argc > 1 ? std::atof(argv[1]) : measure_peak();
+    std::printf("micro-kernel: %s, peak estimate %.1f GFLOP/s double, %.1f float\n",
+                dsa::detail::gemm_isa(), peak64, 2 * peak64);
+    for (int n : {256, 512, 1024, 2048}) {
+        run<float>("float", n, 2 * peak64, n <= 1024);
+    }
+    for (int n : {256, 512, 1024, 2048}) {
+        run<double>("double", n, peak64, n <= 1024);
+    }
+    return 0;
+}
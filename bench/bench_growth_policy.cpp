@@ -0,0 +1,50 @@
+// Append throughput and peak RSS for each growth policy, for a
+// relocatable element (int, grows with realloc) and a non-relocatable
+// one (Boxed, allocate + move + free). Every run is its own process.
+//
+// usage: bench_growth_policy [count]
+
+#include "bench_util.hpp"
+#include "vector.hpp"
+
+#include <cstdio>
+#include <cstdlib>
+
+namespace {
+
+// a user-defined policy: double small vectors, then grow by 25%
+struct UserGrowth {
+    std::size_t operator()(std::size_t cap) const {
+        return cap < 1024 ? std::max<std::size_t>(1, 2 * cap) : cap + cap / 4;
+    }
+};
+
+template <typename T, typename Growth>
+double append(long long n) {
+    bench::Timer t;
+    dsa::Vector<T, Growth> v;
+    for (long long k = 0; k < n; k++) {
+        v.push_back(T(static_cast<int>(k)));
+    }
+    bench::do_not_optimize(v.back());
+    return t.ms();
+}
+
+template <typename T>
+void run_all(const char* type, long long n) {
+    std::printf("\n%s, %lld appends\n", type, n);
+    bench::run_isolated("doubling (default)", append<T, dsa::DoublingGrowth>, n);
+    bench::run_isolated("1.5x factor", append<T, dsa::OneAndHalfGrowth>, n);
+    bench::run_isolated("fixed chunk of 1M elements", append<T, dsa::ChunkGrowth<1 << 20>>, n);
+    bench::run_isolated("page rounded", append<T, dsa::PageRoundedGrowth>, n);
+    bench::run_isolated("user callable (2x, then 1.25x)", append<T, UserGrowth>, n);
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    long long n = argc > 1 ? std::atoll(argv[1]) : 100'000'000LL;
+    run_all<int>("int (relocatable)", n);
+    run_all<bench::Boxed>("Boxed (not relocatable)", n);
+    return 0;
+}
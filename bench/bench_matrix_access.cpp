@@ -0,0 +1,90 @@
+// The operator+ inner loop, c(i, j) = a(i, j) + b(i, j) over 2048x2048
+// float matrices, through each access path Matrix offers: at() (always
+// checked), operator() (checked only when DSA_MATRIX_CHECKED), unchecked(),
+// row spans, raw data() pointers, and the library's own fused operator+.
+// Best of five, ns per element.
+
+#include "bench_util.hpp"
+#include "matrix.hpp"
+
+#include <cstdio>
+#include <span>
+
+namespace {
+
+constexpr int N = 2048;
+using M = dsa::Matrix<float>;
+
+template <typename Fn>
+void run(const char* label, M& a, M& b, M& c, Fn fn) {
+    double best = 1e300;
+    for (int rep = 0; rep < 5; rep++) {
+        bench::Timer t;
+        fn(a, b, c);
+        double ms = t.ms();
+        bench::do_not_optimize(c(N - 1, N - 1));
+        best = ms < best ? ms : best;
+    }
+    std::printf("%-32s %10.3f ms %8.3f ns/element\n", label, best, best * 1e6 / (double(N) * N));
+}
+
+} // namespace
+
+int main() {
+    M a(N, N);
+    M b(N, N);
+    M c(N, N);
+    for (int i = 0; i < N; i++) {
+        for (int j = 0; j < N; j++) {
+            a.unchecked(i, j) = float(i);
+            b.unchecked(i, j) = float(j);
+        }
+    }
+    std::printf("DSA_MATRIX_CHECKED=%d, %d threads for operator+\n", DSA_MATRIX_CHECKED,
+                dsa::parallel::threads());
+
+    run("at()", a, b, c, [](M& a, M& b, M& c) {
+        for (int i = 0; i < N; i++) {
+            for (int j = 0; j < N; j++) {
+                c.at(i, j) = a.at(i, j) + b.at(i, j);
+            }
+        }
+    });
+    run("operator()", a, b, c, [](M& a, M& b, M& c) {
+        for (int i = 0; i < N; i++) {
+            for (int j = 0; j < N; j++) {
+                c(i, j) = a(i, j) + b(i, j);
+            }
+        }
+    });
+    run("unchecked()", a, b, c, [](M& a, M& b, M& c) {
+        for (int i = 0; i < N; i++) {
+            for (int j = 0; j < N; j++) {
+                c.unchecked(i, j) = a.unchecked(i, j) + b.unchecked(i, j);
+            }
+        }
+    });
+    run("row() spans", a, b, c, [](M& a, M& b, M& c) {
+        for (int i = 0; i < N; i++) {
+            std::span<const float> ra = a.row(i);
+            std::span<const float> rb = b.row(i);
+            std::span<float> rc = c.row(i);
+            for (std::size_t j = 0; j < rc.size(); j++) {
+                rc[j] = ra[j] + rb[j];
+            }
+        }
+    });
+    run("data() pointers", a, b, c, [](M& a, M& b, M& c) {
+        const float* pa = a.data();
+        const float* pb = b.data();
+        float* pc = c.data();
+        std::size_t n = std::size_t(N) * N;
+        for (std::size_t k = 0; k < n; k++) {
+            pc[k] = pa[k] + pb[k];
+        }
+    });
+    run("c = a + b", a, b, c, [](M& a, M& b, M& c) {
+        c = a + b;
+    });
+    return 0;
+}
@@ -0,0 +1,87 @@
+// Matrix construction and addition at 4096x4096: the previous layout, a
+// Vector of row Vectors read through at().at(), against the flat
+// row-major buffer dsa::Matrix now uses.
+
+#include "alloc_counter.hpp"
+#include "bench_util.hpp"
+#include "matrix.hpp"
+#include "vector.hpp"
+
+#include <cstdio>
+
+namespace {
+
+constexpr int N = 4096;
+
+// the previous dsa::Matrix, kept here as the baseline
+class NestedMatrix {
+private:
+    int rows{0};
+    int cols{0};
+    dsa::Vector<dsa::Vector<int>> data;
+
+public:
+    NestedMatrix(int r, int c) : rows(r), cols(c) {
+        data.reserve(rows);
+        for (int i = 0; i < rows; i++) {
+            dsa::Vector<int> row_vec;
+            row_vec.reserve(cols);
+            for (int j = 0; j < cols; j++) {
+                row_vec.push_back(0);
+            }
+            data.push_back(std::move(row_vec));
+        }
+    }
+
+    int& operator()(int i, int j) {
+        return data.at(i).at(j);
+    }
+
+    NestedMatrix operator+(NestedMatrix& other) {
+        NestedMatrix result(rows, cols);
+        for (int i = 0; i < rows; i++) {
+            for (int j = 0; j < cols; j++) {
+                result(i, j) = (*this)(i, j) + other(i, j);
+            }
+        }
+        return result;
+    }
+};
+
+void report(const char* label, double ms, double bytes, long long allocs) {
+    std::printf("%-40s %10.3f ms %8.2f GB/s %10lld mallocs\n",
+                label, ms, bytes / 1e9 / (ms / 1e3), allocs);
+}
+
+template <typename M>
+void run(const char* name) {
+    double bytes = double(N) * N * sizeof(int);
+    char label[64];
+
+    long long before = bench::allocations;
+    bench::Timer t;
+    M a(N, N);
+    double ms = t.ms();
+    std::snprintf(label, sizeof(label), "%s construct", name);
+    report(label, ms, bytes, bench::allocations - before);
+
+    M b(N, N);
+    a(1, 2) = 3;
+    b(1, 2) = 4;
+    before = bench::allocations;
+    t.reset();
+    M c = a + b;
+    ms = t.ms();
+    bench::do_not_optimize(c(1, 2));
+    std::snprintf(label, sizeof(label), "%s operator+", name);
+    report(label, ms, 3 * bytes, bench::allocations - before);
+}
+
+} // namespace
+
+int main() {
+    std::printf("%dx%d int matrices (GB/s counts bytes read + written)\n", N, N);
+    run<NestedMatrix>("nested rows");
+    run<dsa::Matrix<int>>("flat");
+    return 0;
+}
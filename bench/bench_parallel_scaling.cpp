@@ -0,0 +1,104 @@
+// Speedup of the pooled Matrix operations against thread count:
+// elementwise +, -, scalar *, transpose (8192x8192 float, memory bound)
+// and operator* (2048x2048 float, compute bound). Each row reports the
+// best of three runs and the speedup over one thread.
+//     bench_parallel_scaling [max_threads]
+// max_threads defaults to hardware_concurrency(); thread counts double
+// from 1 up to it.
+
+#include "bench_util.hpp"
+#include "matrix.hpp"
+#include "thread_pool.hpp"
+
+#include <cstdio>
+#include <cstdlib>
+#include <thread>
+#include <vector>
+
+namespace {
+
+constexpr int N = 8192;
+constexpr int G = 2048;
+
+template <typename Fn>
+double best_of_three(Fn fn) {
+    double best = 1e300;
+    for (int rep = 0; rep < 3; rep++) {
+        bench::Timer t;
+        fn();
+        double ms = t.ms();
+        best = ms < best ? ms : best;
+    }
+    return best;
+}
+
+struct Op {
+    const char* name;
+    double bytes;  // moved per run, 0 for compute-bound ops
+    double flops;
+    std::vector<double> ms;
+};
+
+} // namespace
+
+int main(int argc, char** argv) {
+    unsigned max_threads = argc > 1 ? static_cast<unsigned>(std::atoi(argv[1]))
+                                    : std::thread::hardware_concurrency();
+    if (max_threads == 0) {
+        max_threads = 1;
+    }
+
+    dsa::Matrix<float> a(N, N);
+    dsa::Matrix<float> b(N, N);
+    for (int i = 0; i < N; i++) {
+        for (int j = 0; j < N; j++) {
+            a(i, j) = float(i % 7);
+            b(i, j) = float(j % 5);
+        }
+    }
+    dsa::Matrix<float> ga(G, G);
+    dsa::Matrix<float> gb(G, G);
+    for (int i = 0; i < G; i++) {
+        for (int j = 0; j < G; j++) {
+            ga(i, j) = float((i + j) % 9) / 9.0f;
+            gb(i, j) = float((i * j) % 7) / 7.0f;
+        }
+    }
+
+    double mat = double(N) * N * sizeof(float);
+    Op ops[] = {{"operator+", 3 * mat, 0, {}},
+                {"operator-", 3 * mat, 0, {}},
+                {"operator*(scalar)", 2 * mat, 0, {}},
+                {"transpose", 2 * mat, 0, {}},
+                {"operator* 2048", 0, 2.0 * G * G * G, {}}};
+
+    std::vector<unsigned> counts;
+    for (unsigned t = 1; t < max_threads; t *= 2) {
+        counts.push_back(t);
+    }
+    counts.push_back(max_threads);
+
+    for (unsigned t : counts) {
+        dsa::parallel::set_threads(t);
+        ops[0].ms.push_back(best_of_three([&] { bench::do_not_optimize(a + b); }));
+        ops[1].ms.push_back(best_of_three([&] { bench::do_not_optimize(a - b); }));
+        ops[2].ms.push_back(best_of_three([&] { bench::do_not_optimize(a * 2.0f); }));
+        ops[3].ms.push_back(best_of_three([&] { bench::do_not_optimize(a.transpose()); }));
+        ops[4].ms.push_back(best_of_three([&] { bench::do_not_optimize(ga * gb); }));
+    }
+
+    std::printf("%-20s %8s %10s %8s %12s\n", "operation", "threads", "ms", "speedup", "throughput");
+    for (const Op& op : ops) {
+        for (std::size_t i = 0; i < counts.size(); i++) {
+            double ms = op.ms[i];
+            if (op.bytes > 0) {
+                std::printf("%-20s %8u %10.3f %7.2fx %7.2f GB/s\n", op.name, counts[i], ms,
+                            op.ms[0] / ms, op.bytes / 1e9 / (ms / 1e3));
+            } else {
+                std::printf("%-20s %8u %10.3f %7.2fx %7.1f GFLOP/s\n", op.name, counts[i], ms,
+                            op.ms[0] / ms, op.flops / 1e9 / (ms / 1e3));
+            }
+        }
+    }
+    return 0;
+}
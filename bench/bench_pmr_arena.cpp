@@ -0,0 +1,101 @@
+// Request-scoped build-and-discard: each simulated request builds a
+// table of rows plus a few scratch vectors, reads them and throws them
+// away. Compares the global heap with a std::pmr monotonic arena that is
+// released in one shot at the end of every request.
+
+#include "alloc_counter.hpp"
+#include "bench_util.hpp"
+#include "vector.hpp"
+
+#include <cstddef>
+#include <cstdio>
+#include <memory_resource>
+
+namespace {
+
+constexpr int REQUESTS = 100'000;
+constexpr int ROWS = 32;
+constexpr int ROW_LEN = 16;
+constexpr int SCRATCH = 4;
+constexpr int SCRATCH_LEN = 100;
+
+// one request; Outer/Inner are the table and row vector types, make
+// builds an empty one of either
+template <typename Outer, typename Inner, typename Make>
+long long handle_request(Make make) {
+    Outer table = make.template operator()<Outer>();
+    for (int i = 0; i < ROWS; i++) {
+        Inner& row = table.emplace_back();
+        for (int j = 0; j < ROW_LEN; j++) {
+            row.push_back(i + j);
+        }
+    }
+    long long sum = 0;
+    for (int s = 0; s < SCRATCH; s++) {
+        Inner scratch = make.template operator()<Inner>();
+        for (int k = 0; k < SCRATCH_LEN; k++) {
+            scratch.push_back(k * s);
+        }
+        sum += scratch.back();
+    }
+    for (const auto& row : table) {
+        sum += row.back();
+    }
+    return sum;
+}
+
+void report(const char* label, double ms, long long allocs) {
+    std::printf("%-40s %10.3f ms %8.0f ns/request", label, ms, ms * 1e6 / REQUESTS);
+    if (bench::counting_allocations) {
+        std::printf(" %12lld mallocs\n", allocs);
+    } else {
+        std::printf("   mallocs n/a\n");
+    }
+}
+
+void run_heap() {
+    auto make = []<typename V>() { return V(); };
+    long long before = bench::allocations;
+    long long sum = 0;
+    bench::Timer t;
+    for (int r = 0; r < REQUESTS; r++) {
+        sum += handle_request<dsa::Vector<dsa::Vector<int>>, dsa::Vector<int>>(make);
+    }
+    double ms = t.ms();
+    bench::do_not_optimize(sum);
+    report("global heap (dsa::Vector)", ms, bench::allocations - before);
+}
+
+void run_pmr(const char* label, std::pmr::memory_resource* upstream, bool arena) {
+    using Inner = dsa::pmr::Vector<int>;
+    using Outer = dsa::pmr::Vector<Inner>;
+    alignas(std::max_align_t) static std::byte buffer[64 * 1024];
+
+    long long before = bench::allocations;
+    long long sum = 0;
+    bench::Timer t;
+    for (int r = 0; r < REQUESTS; r++) {
+        if (arena) {
+            std::pmr::monotonic_buffer_resource mono(buffer, sizeof(buffer), upstream);
+            auto make = [&]<typename V>() { return V(&mono); };
+            sum += handle_request<Outer, Inner>(make);
+        } else {
+            auto make = [&]<typename V>() { return V(upstream); };
+            sum += handle_request<Outer, Inner>(make);
+        }
+    }
+    double ms = t.ms();
+    bench::do_not_optimize(sum);
+    report(label, ms, bench::allocations - before);
+}
+
+} // namespace
+
+int main() {
+    std::printf("%d requests: %d rows of %d ints + %d scratch vectors of %d\n",
+                REQUESTS, ROWS, ROW_LEN, SCRATCH, SCRATCH_LEN);
+    run_heap();
+    run_pmr("pmr, new_delete_resource", std::pmr::new_delete_resource(), false);
+    run_pmr("pmr, monotonic arena per request", std::pmr::new_delete_resource(), true);
+    return 0;
+}
@@ -0,0 +1,101 @@
+// Constructor calls and time spent by reserve() and push_back growth
+// for a non-trivial element type: dsa::Vector, which only constructs
+// elements as they are added, against the previous new T[cap] scheme,
+// which default-constructs every slot up to capacity.
+
+#include "bench_util.hpp"
+#include "vector.hpp"
+
+#include <cstring>
+
+namespace {
+
+long long constructions = 0;
+
+// 256-byte element whose default constructor does real work
+struct Heavy {
+    char payload[256];
+
+    Heavy() {
+        std::memset(payload, 0, sizeof(payload));
+        constructions++;
+    }
+    Heavy(const Heavy& other) {
+        std::memcpy(payload, other.payload, sizeof(payload));
+        constructions++;
+    }
+    Heavy& operator=(const Heavy& other) {
+        std::memcpy(payload, other.payload, sizeof(payload));
+        return *this;
+    }
+};
+
+// the allocation pattern dsa::Vector used before: new T[n] + assignment
+void old_reserve(Heavy*& data, int& cap, int sz, int minimum) {
+    if (cap < minimum) {
+        Heavy* new_array = new Heavy[minimum];
+        for (int k = 0; k < sz; k++) {
+            new_array[k] = data[k];
+        }
+        delete[] data;
+        data = new_array;
+        cap = minimum;
+    }
+}
+
+void run_reserve(int n) {
+    std::printf("\nreserve(%d), no elements added\n", n);
+
+    constructions = 0;
+    bench::Timer t;
+    Heavy* data = nullptr;
+    int cap = 0;
+    old_reserve(data, cap, 0, n);
+    bench::do_not_optimize(data);
+    bench::report("new T[cap]", t.ms(), constructions);
+    delete[] data;
+
+    constructions = 0;
+    t.reset();
+    dsa::Vector<Heavy> v;
+    v.reserve(n);
+    bench::do_not_optimize(v);
+    bench::report("dsa::Vector raw storage", t.ms(), constructions);
+}
+
+void run_growth(int n) {
+    std::printf("\npush_back x %d with doubling growth\n", n);
+    Heavy proto;
+
+    constructions = 0;
+    bench::Timer t;
+    Heavy* data = nullptr;
+    int cap = 0;
+    for (int sz = 0; sz < n; sz++) {
+        if (sz == cap) {
+            old_reserve(data, cap, sz, std::max(1, 2 * cap));
+        }
+        data[sz] = proto;
+    }
+    bench::do_not_optimize(data);
+    bench::report("new T[cap]", t.ms(), constructions);
+    delete[] data;
+
+    constructions = 0;
+    t.reset();
+    dsa::Vector<Heavy> v;
+    for (int k = 0; k < n; k++) {
+        v.push_back(proto);
+    }
+    bench::do_not_optimize(v);
+    bench::report("dsa::Vector raw storage", t.ms(), constructions);
+}
+
+} // namespace
+
+int main() {
+    std::printf("%-40s %13s %14s\n", "", "time", "constructions");
+    run_reserve(1'000'000);
+    run_growth(1'000'000);
+    return 0;
+}
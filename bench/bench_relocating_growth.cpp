@@ -0,0 +1,42 @@
+// Ingestion benchmark: push_back N ints (default 1 billion) with doubling
+// growth. Vector<int> is relocatable and grows with realloc/mremap; the
+// bench::Boxed wrapper is not, so it takes the allocate + move + free path.
+// Each variant runs in its own child process so peak RSS is reported per
+// variant.
+//
+// usage: bench_relocating_growth [count] [relocating|moving|both]
+
+#include "bench_util.hpp"
+#include "vector.hpp"
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+namespace {
+
+template <typename T>
+double ingest(long long n) {
+    bench::Timer t;
+    dsa::Vector<T> v;
+    for (long long k = 0; k < n; k++) {
+        v.push_back(T(static_cast<int>(k)));
+    }
+    bench::do_not_optimize(v.back());
+    return t.ms();
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    long long n = argc > 1 ? std::atoll(argv[1]) : 1'000'000'000LL;
+    const char* which = argc > 2 ? argv[2] : "both";
+    std::printf("appending %lld ints\n", n);
+    if (std::strcmp(which, "moving") != 0) {
+        bench::run_isolated("relocating (realloc/mremap)", ingest<int>, n);
+    }
+    if (std::strcmp(which, "relocating") != 0) {
+        bench::run_isolated("moving (allocate+copy+free)", ingest<bench::Boxed>, n);
+    }
+    return 0;
+}
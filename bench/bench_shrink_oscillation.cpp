@@ -0,0 +1,59 @@
+// Queue-like stress around the shrink boundary: the size swings between
+// capacity/4 and just past capacity/2, so the default policy halves the
+// buffer on the way down and doubles it again on the way up, moving
+// every element each time. Compares the shrink policies on reallocation
+// count and time.
+
+#include "bench_util.hpp"
+#include "vector.hpp"
+
+#include <cstddef>
+#include <cstdio>
+
+namespace {
+
+constexpr int LOW = 1 << 19;       // shrink fires when size reaches cap/4
+constexpr int HIGH = (1 << 20) + 1; // one past cap/2 forces regrowth
+constexpr int CYCLES = 40;
+
+void run(const char* label, dsa::ShrinkPolicy policy) {
+    dsa::Vector<bench::Boxed> v;
+    v.set_shrink_policy(policy);
+    for (int k = 0; k < HIGH; k++) {
+        v.push_back(bench::Boxed(k));
+    }
+
+    long long reallocations = 0;
+    std::size_t last_cap = v.capacity();
+    bench::Timer t;
+    for (int c = 0; c < CYCLES; c++) {
+        while (v.size() > LOW) {
+            v.pop_back();
+            if (v.capacity() != last_cap) {
+                reallocations++;
+                last_cap = v.capacity();
+            }
+        }
+        while (v.size() < HIGH) {
+            v.push_back(bench::Boxed(c));
+            if (v.capacity() != last_cap) {
+                reallocations++;
+                last_cap = v.capacity();
+            }
+        }
+    }
+    bench::do_not_optimize(v.back());
+    bench::report(label, t.ms(), reallocations);
+}
+
+} // namespace
+
+int main() {
+    std::printf("size oscillating between %d and %d, %d cycles\n", LOW, HIGH, CYCLES);
+    std::printf("%-40s %13s %14s\n", "", "time", "reallocations");
+    run("automatic 1/4 -> 1/2 (default)", dsa::ShrinkPolicy::automatic());
+    run("automatic 1/8 -> 1/2", dsa::ShrinkPolicy::automatic(8, 2));
+    run("explicit only", dsa::ShrinkPolicy::explicit_only());
+    run("never", dsa::ShrinkPolicy::never());
+    return 0;
+}
@@ -0,0 +1,51 @@
+// Many short vectors: build, sum and destroy vectors of 1..8 ints, the
+// way per-item scratch lists are used. Compares heap allocations and
+// per-vector latency of dsa::Vector against dsa::SmallVector<int, 8>.
+
+#include "alloc_counter.hpp"
+#include "bench_util.hpp"
+#include "small_vector.hpp"
+#include "vector.hpp"
+
+#include <cstdio>
+
+namespace {
+
+constexpr int COUNT = 2'000'000;
+
+template <typename Vec>
+void run(const char* label) {
+    long long before = bench::allocations;
+    long long sum = 0;
+    bench::Timer t;
+    for (int k = 0; k < COUNT; k++) {
+        Vec v;
+        int len = 1 + k % 8;
+        for (int i = 0; i < len; i++) {
+            v.push_back(i);
+        }
+        for (const auto& x : v) {
+            sum += x;
+        }
+        bench::do_not_optimize(v);
+    }
+    double ms = t.ms();
+    bench::do_not_optimize(sum);
+    std::printf("%-40s %10.3f ms %8.1f ns/vector", label, ms, ms * 1e6 / COUNT);
+    if (bench::counting_allocations) {
+        std::printf(" %12lld allocations\n", bench::allocations - before);
+    } else {
+        std::printf("   allocations n/a\n");
+    }
+}
+
+} // namespace
+
+int main() {
+    std::printf("%d vectors of 1..8 ints\n", COUNT);
+    run<dsa::Vector<int>>("dsa::Vector<int>");
+    run<dsa::SmallVector<int, 8>>("dsa::SmallVector<int, 8>");
+    run<dsa::Vector<bench::Boxed>>("dsa::Vector<Boxed>");
+    run<dsa::SmallVector<bench::Boxed, 8>>("dsa::SmallVector<Boxed, 8>");
+    return 0;
+}
@@ -0,0 +1,171 @@
+// SparseMatrix<float> on synthetic power-law patterns: row degrees are
+// Pareto distributed (most rows have a handful of entries, a few have
+// thousands) and column indices are skewed toward a hot set, like a web
+// or social graph. Times building CSR from triplets, CSR -> CSC, SpMV
+// (CSR on 1..N threads of the shared pool, CSC serial), sparse + sparse
+// and Gustavson sparse * sparse, and compares SpMV with a dense
+// matrix-vector product at a size where the dense matrix still fits.
+// SpMV GB/s counts the compressed arrays plus x and y once.
+//     bench_sparse [rows] [average degree]
+
+#include "bench_util.hpp"
+#include "sparse_matrix.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <thread>
+
+namespace {
+
+using Sparse = dsa::SparseMatrix<float>;
+
+template <typename Fn>
+double best_of_three(Fn fn) {
+    double best = 1e300;
+    for (int rep = 0; rep < 3; rep++) {
+        bench::Timer t;
+        fn();
+        double ms = t.ms();
+        best = ms < best ? ms : best;
+    }
+    return best;
+}
+
+// n x n, Pareto(alpha = 1.5) row degrees scaled to the given mean,
+// columns n * u^3 for uniform u (a few columns get most of the entries)
+dsa::Vector<dsa::Triplet<float>> power_law(int n, double degree, unsigned seed) {
+    std::mt19937_64 rng(seed);
+    std::uniform_real_distribution<double> uniform(0.0, 1.0);
+    const double alpha = 1.5;
+    const double min_degree = degree * (alpha - 1) / alpha; // Pareto mean = min * alpha / (alpha - 1)
+    dsa::Vector<dsa::Triplet<float>> t;
+    t.reserve(static_cast<std::size_t>(n * degree * 1.1));
+    for (int i = 0; i < n; i++) {
+        double d = min_degree / std::pow(1.0 - uniform(rng), 1.0 / alpha);
+        int count = static_cast<int>(std::min<double>(d, n / 8));
+        for (int k = 0; k < count; k++) {
+            double u = uniform(rng);
+            int j = static_cast<int>(n * u * u * u);
+            t.push_back({i, j, static_cast<float>(uniform(rng))});
+        }
+    }
+    return t;
+}
+
+double spmv_bytes(const Sparse& a) {
+    return double(a.nonzeros()) * (sizeof(float) + sizeof(int))
+         + double(a.offsets().size()) * sizeof(std::size_t)
+         + double(a.cols() + a.rows()) * sizeof(float);
+}
+
+void run_large(int n, double degree) {
+    auto triplets = power_law(n, degree, 42);
+    std::printf("%d x %d, %zu triplets (mean degree %.1f, alpha 1.5)\n",
+                n, n, triplets.size(), degree);
+
+    Sparse a(0, 0);
+    double ms = best_of_three([&] { a = Sparse(n, n, triplets); });
+    std::size_t max_row = 0;
+    for (int i = 0; i < n; i++) {
+        max_row = std::max(max_row, a.offsets()[i + 1] - a.offsets()[i]);
+    }
+    std::printf("%-36s %10.3f ms %8.1f M triplets/s\n", "build CSR from triplets", ms,
+                triplets.size() / 1e3 / ms);
+    std::printf("  %zu nonzeros after merging duplicates, densest row %zu\n", a.nonzeros(), max_row);
+    std::printf("  CSR %.1f MB, dense Matrix<float> would be %.1f GB\n",
+                spmv_bytes(a) / 1e6, double(n) * n * sizeof(float) / 1e9);
+
+    Sparse c(0, 0);
+    ms = best_of_three([&] { c = a.to_csc(); });
+    std::printf("%-36s %10.3f ms\n", "CSR -> CSC", ms);
+
+    dsa::Vector<float> x;
+    for (int j = 0; j < n; j++) {
+        x.push_back(1.0f / static_cast<float>(j + 1));
+    }
+    dsa::Vector<float> y = a * x;
+    double bytes = spmv_bytes(a);
+    double flops = 2.0 * a.nonzeros();
+    char label[64];
+
+    unsigned hw = std::max(1u, std::thread::hardware_concurrency());
+    for (unsigned threads = 1; ; threads *= 2) {
+        threads = std::min(threads, hw);
+        dsa::parallel::set_threads(threads);
+        ms = best_of_three([&] {
+            a.spmv(x.data(), y.data());
+            bench::do_not_optimize(y[0]);
+        });
+        std::snprintf(label, sizeof(label), "SpMV CSR, %u thread%s", threads, threads == 1 ? "" : "s");
+        std::printf("%-36s %10.3f ms %8.2f GB/s %8.2f GFLOP/s\n", label, ms,
+                    bytes / 1e9 / (ms / 1e3), flops / 1e9 / (ms / 1e3));
+        if (threads == hw) {
+            break;
+        }
+    }
+    dsa::parallel::set_threads(0);
+
+    ms = best_of_three([&] {
+        c.spmv(x.data(), y.data());
+        bench::do_not_optimize(y[0]);
+    });
+    std::printf("%-36s %10.3f ms %8.2f GB/s %8.2f GFLOP/s\n", "SpMV CSC (serial scatter)", ms,
+                bytes / 1e9 / (ms / 1e3), flops / 1e9 / (ms / 1e3));
+
+    ms = best_of_three([&] {
+        Sparse s = a + c;
+        bench::do_not_optimize(s.nonzeros());
+    });
+    std::printf("%-36s %10.3f ms\n", "A + A (CSR + CSC)", ms);
+}
+
+void run_product(int n, double degree) {
+    Sparse a(n, n, power_law(n, degree, 7));
+    Sparse p(0, 0);
+    double ms = best_of_three([&] { p = a * a; });
+    std::printf("%-36s %10.3f ms  %d x %d, %zu -> %zu nonzeros\n", "A * A (Gustavson)", ms,
+                n, n, a.nonzeros(), p.nonzeros());
+}
+
+void run_dense_comparison(int n, double degree) {
+    Sparse a(n, n, power_law(n, degree, 3));
+    dsa::Matrix<float> d = a.to_dense();
+    dsa::Vector<float> x;
+    for (int j = 0; j < n; j++) {
+        x.push_back(1.0f);
+    }
+    dsa::Vector<float> y = a * x;
+    double ms = best_of_three([&] {
+        const float* m = d.data();
+        std::size_t ld = d.stride();
+        for (int i = 0; i < n; i++) {
+            float sum = 0;
+            for (int j = 0; j < n; j++) {
+                sum += m[i * ld + j] * x[j];
+            }
+            y[i] = sum;
+        }
+        bench::do_not_optimize(y[0]);
+    });
+    std::printf("%-36s %10.3f ms  %d x %d, %.2f%% nonzero\n", "dense matrix-vector", ms, n, n,
+                100.0 * a.nonzeros() / (double(n) * n));
+    ms = best_of_three([&] {
+        a.spmv(x.data(), y.data());
+        bench::do_not_optimize(y[0]);
+    });
+    std::printf("%-36s %10.3f ms\n", "SpMV CSR, same matrix", ms);
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    int n = argc > 1 ? std::atoi(argv[1]) : 1 << 20;
+    double degree = argc > 2 ? std::atof(argv[2]) : 16.0;
+    run_large(n, degree);
+    run_product(1 << 16, 8.0);
+    run_dense_comparison(8192, degree);
+    return 0;
+}
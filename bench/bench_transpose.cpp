@@ -0,0 +1,101 @@
+// Transposing an 8192x8192 matrix (256 MiB of float or int): the naive
+// dst[j][i] = src[i][j] loop, Matrix::transpose() (cache-oblivious
+// blocking, in-register 8x8 tiles, the shared pool) and
+// transpose_in_place(), plus the blocked kernel alone into an existing
+// buffer (transpose() also pays for the new Matrix), against memcpy of the same buffer as the memory
+// bandwidth ceiling. GB/s counts one read and one write of the matrix.
+//     bench_transpose [n]
+
+#include "bench_util.hpp"
+#include "matrix.hpp"
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+namespace {
+
+template <typename Fn>
+double best_of_three(Fn fn) {
+    double best = 1e300;
+    for (int rep = 0; rep < 3; rep++) {
+        bench::Timer t;
+        fn();
+        double ms = t.ms();
+        best = ms < best ? ms : best;
+    }
+    return best;
+}
+
+void report(const char* label, double ms, double bytes) {
+    std::printf("%-40s %10.3f ms %8.2f GB/s\n", label, ms, 2 * bytes / 1e9 / (ms / 1e3));
+}
+
+template <typename T>
+void run(const char* type, int n) {
+    dsa::Matrix<T> a(n, n);
+    for (int i = 0; i < n; i++) {
+        for (int j = 0; j < n; j++) {
+            a.unchecked(i, j) = static_cast<T>(i ^ j);
+        }
+    }
+    dsa::Matrix<T> out(n, n);
+    double bytes = double(n) * n * sizeof(T);
+    char label[64];
+
+    double ms = best_of_three([&] {
+        std::memcpy(out.data(), a.data(), static_cast<std::size_t>(bytes));
+        bench::do_not_optimize(out.data()[1]);
+    });
+    std::snprintf(label, sizeof(label), "%s memcpy (bandwidth)", type);
+    report(label, ms, bytes);
+
+    ms = best_of_three([&] {
+        const T* src = a.data();
+        T* dst = out.data();
+        std::size_t s = static_cast<std::size_t>(n);
+        for (std::size_t i = 0; i < s; i++) {
+            for (std::size_t j = 0; j < s; j++) {
+                dst[j * s + i] = src[i * s + j];
+            }
+        }
+        bench::do_not_optimize(dst[1]);
+    });
+    std::snprintf(label, sizeof(label), "%s naive loop", type);
+    report(label, ms, bytes);
+
+    // the blocked kernel alone, into the existing buffer on this thread
+    ms = best_of_three([&] {
+        std::size_t s = static_cast<std::size_t>(n);
+        dsa::detail::transpose_rows(a.data(), s, out.data(), s, 0, s, s);
+        bench::do_not_optimize(out.data()[1]);
+    });
+    std::snprintf(label, sizeof(label), "%s blocked kernel, 1 thread", type);
+    report(label, ms, bytes);
+
+    // what callers see: a new Matrix per call
+    ms = best_of_three([&] {
+        out = a.transpose();
+        bench::do_not_optimize(out.data()[1]);
+    });
+    std::snprintf(label, sizeof(label), "%s transpose()", type);
+    report(label, ms, bytes);
+
+    ms = best_of_three([&] {
+        a.transpose_in_place();
+        bench::do_not_optimize(a.data()[1]);
+    });
+    std::snprintf(label, sizeof(label), "%s transpose_in_place()", type);
+    report(label, ms, bytes);
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    int n = argc > 1 ? std::atoi(argv[1]) : 8192;
+    std::printf("%dx%d, %d threads\n", n, n, dsa::parallel::threads());
+    run<float>("float", n);
+    run<int>("int", n);
+    run<double>("double", n / 2);
+    return 0;
+}
@@ -0,0 +1,85 @@
+#pragma once
+
+// Small helpers shared by the standalone benchmark executables in bench/.
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+
+#if defined(__unix__)
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#endif
+
+namespace bench {
+
+// wall-clock stopwatch, started on construction
+class Timer {
+private:
+    std::chrono::steady_clock::time_point start{std::chrono::steady_clock::now()};
+
+public:
+    void reset() {
+        start = std::chrono::steady_clock::now();
+    }
+
+    // elapsed time in milliseconds
+    double ms() const {
+        std::chrono::duration<double, std::milli> d = std::chrono::steady_clock::now() - start;
+        return d.count();
+    }
+};
+
+// an int that is not trivially copyable, hence not relocatable: every
+// reallocation has to move it element by element
+struct Boxed {
+    int value;
+    Boxed(int v) : value(v) {}
+    Boxed(const Boxed& other) : value(other.value) {}
+    operator int() const { return value; }
+    Boxed& operator=(const Boxed& other) { value = other.value; return *this; }
+};
+
+// keep the optimizer from discarding a value we computed only to time it
+template <typename T>
+inline void do_not_optimize(const T& value) {
+    asm volatile("" : : "r,m"(value) : "memory");
+}
+
+// one aligned result row: label, time, and an optional counter
+inline void report(const char* label, double ms, long long count = -1) {
+    if (count < 0) {
+        std::printf("%-40s %10.3f ms\n", label, ms);
+    } else {
+        std::printf("%-40s %10.3f ms %14lld\n", label, ms, count);
+    }
+}
+
+#if defined(__unix__)
+// Run fn(arg) -> milliseconds in a child process so that its peak RSS is
+// measured on its own. The child prints the label and time, the parent
+// appends the child's peak RSS. Returns false if the child failed.
+template <typename Fn, typename Arg>
+bool run_isolated(const char* label, Fn fn, Arg arg) {
+    std::fflush(stdout);
+    pid_t pid = fork();
+    if (pid == 0) {
+        double ms = fn(arg);
+        std::printf("%-40s %10.1f ms", label, ms);
+        std::fflush(stdout);
+        std::_Exit(0);
+    }
+    int status = 0;
+    rusage usage{};
+    wait4(pid, &status, 0, &usage);
+    if (WIFEXITED(status) && WEXITSTATUS(status) == 0) {
+        std::printf(" %10.1f MiB peak RSS\n", usage.ru_maxrss / 1024.0);
+        return true;
+    }
+    std::printf("%-40s failed (out of memory?)\n", label);
+    return false;
+}
+#endif
+
+} // namespace bench
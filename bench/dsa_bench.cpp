@@ -0,0 +1,320 @@
+// Microbenchmark suite for Vector and Matrix, on the vendored minibench
+// harness (bench/minibench/benchmark.hpp). Run it before and after a
+// change and compare:
+//     dsa_bench --benchmark_out=before.json
+//     dsa_bench --benchmark_compare=before.json
+// Sizes are element counts (Vector) or the side of a square Matrix.
+
+#include "minibench/benchmark.hpp"
+#include "matrix.hpp"
+#include "vector.hpp"
+
+#include <cstdint>
+#include <utility>
+
+namespace {
+
+constexpr std::int64_t small = 8;
+constexpr std::int64_t large = 1 << 18;
+
+// where insert and erase act: 0 front, 1 middle, 2 back
+std::size_t position(std::int64_t where, std::size_t size) {
+    return where == 0 ? 0 : where == 1 ? size / 2 : size;
+}
+
+dsa::Vector<int> filled(std::int64_t n) {
+    dsa::Vector<int> v;
+    v.reserve(static_cast<std::size_t>(n));
+    for (std::int64_t i = 0; i < n; i++) {
+        v.push_back(static_cast<int>(i));
+    }
+    return v;
+}
+
+void BM_VectorPushBack(benchmark::State& state) {
+    std::int64_t n = state.range(0);
+    for (auto _ : state) {
+        dsa::Vector<int> v;
+        for (std::int64_t i = 0; i < n; i++) {
+            v.push_back(static_cast<int>(i));
+        }
+        benchmark::DoNotOptimize(v.data());
+    }
+    state.SetItemsProcessed(state.iterations() * n);
+    state.SetBytesProcessed(state.iterations() * n * std::int64_t(sizeof(int)));
+}
+BENCHMARK(BM_VectorPushBack)->Range(small, large);
+
+void BM_VectorPushBackReserved(benchmark::State& state) {
+    std::int64_t n = state.range(0);
+    for (auto _ : state) {
+        dsa::Vector<int> v;
+        v.reserve(static_cast<std::size_t>(n));
+        for (std::int64_t i = 0; i < n; i++) {
+            v.push_back(static_cast<int>(i));
+        }
+        benchmark::DoNotOptimize(v.data());
+    }
+    state.SetItemsProcessed(state.iterations() * n);
+    state.SetBytesProcessed(state.iterations() * n * std::int64_t(sizeof(int)));
+}
+BENCHMARK(BM_VectorPushBackReserved)->Range(small, large);
+
+// 64 inserts into a Vector of n elements; the extra elements are
+// removed from the back outside the timed region
+void BM_VectorInsert(benchmark::State& state) {
+    constexpr int batch = 64;
+    std::int64_t n = state.range(0);
+    dsa::Vector<int> v = filled(n);
+    v.reserve(static_cast<std::size_t>(n) + batch);
+    for (auto _ : state) {
+        for (int k = 0; k < batch; k++) {
+            v.insert(position(state.range(1), v.size()), k);
+        }
+        benchmark::DoNotOptimize(v.data());
+        state.PauseTiming();
+        for (int k = 0; k < batch; k++) {
+            v.pop_back();
+        }
+        state.ResumeTiming();
+    }
+    state.SetItemsProcessed(state.iterations() * batch);
+}
+BENCHMARK(BM_VectorInsert)->ArgsProduct({{small * 8, 4096, large}, {0, 1, 2}});
+
+// 64 erases from a Vector of n + 64 elements, refilled untimed
+void BM_VectorErase(benchmark::State& state) {
+    constexpr int batch = 64;
+    std::int64_t n = state.range(0);
+    dsa::Vector<int> v = filled(n + batch);
+    for (auto _ : state) {
+        for (int k = 0; k < batch; k++) {
+            std::size_t i = position(state.range(1), v.size());
+            v.erase(i == v.size() ? i - 1 : i);
+        }
+        benchmark::DoNotOptimize(v.data());
+        state.PauseTiming();
+        for (int k = 0; k < batch; k++) {
+            v.push_back(k);
+        }
+        state.ResumeTiming();
+    }
+    state.SetItemsProcessed(state.iterations() * batch);
+}
+BENCHMARK(BM_VectorErase)->ArgsProduct({{small * 8, 4096, large}, {0, 1, 2}});
+
+// the same n elements as BM_VectorPushBack, appended as one range
+void BM_VectorAppend(benchmark::State& state) {
+    std::int64_t n = state.range(0);
+    dsa::Vector<int> src = filled(n);
+    for (auto _ : state) {
+        dsa::Vector<int> v;
+        v.append(src.begin(), src.end());
+        benchmark::DoNotOptimize(v.data());
+    }
+    state.SetItemsProcessed(state.iterations() * n);
+    state.SetBytesProcessed(state.iterations() * n * std::int64_t(sizeof(int)));
+}
+BENCHMARK(BM_VectorAppend)->Range(small, large);
+
+// a block of 64 inserted in the middle of n elements at once, against
+// the 64 single inserts of BM_VectorInsert/n/1
+void BM_VectorInsertRange(benchmark::State& state) {
+    constexpr int batch = 64;
+    std::int64_t n = state.range(0);
+    dsa::Vector<int> v = filled(n);
+    dsa::Vector<int> block = filled(batch);
+    v.reserve(static_cast<std::size_t>(n) + batch);
+    for (auto _ : state) {
+        v.insert(v.size() / 2, block.begin(), block.end());
+        benchmark::DoNotOptimize(v.data());
+        state.PauseTiming();
+        for (int k = 0; k < batch; k++) {
+            v.pop_back();
+        }
+        state.ResumeTiming();
+    }
+    state.SetItemsProcessed(state.iterations() * batch);
+}
+BENCHMARK(BM_VectorInsertRange)->Arg(small * 8)->Arg(4096)->Arg(large);
+
+// prune every 16th element of n: one erase_if pass, one remove_indices
+// pass over the same indices, and erase(i) per index from the back (the
+// cheapest order for single erases); the vector is restored untimed
+void BM_VectorEraseIf(benchmark::State& state) {
+    std::int64_t n = state.range(0);
+    dsa::Vector<int> src = filled(n);
+    dsa::Vector<int> v;
+    for (auto _ : state) {
+        state.PauseTiming();
+        v.assign(src.begin(), src.end());
+        state.ResumeTiming();
+        v.erase_if([](int x) { return x % 16 == 0; });
+        benchmark::DoNotOptimize(v.data());
+    }
+    state.SetItemsProcessed(state.iterations() * n);
+}
+BENCHMARK(BM_VectorEraseIf)->Arg(4096)->Arg(large)->Arg(large * 8);
+
+void BM_VectorRemoveIndices(benchmark::State& state) {
+    std::int64_t n = state.range(0);
+    dsa::Vector<int> src = filled(n);
+    dsa::Vector<std::size_t> indices;
+    for (std::int64_t i = 0; i < n; i += 16) {
+        indices.push_back(static_cast<std::size_t>(i));
+    }
+    dsa::Vector<int> v;
+    for (auto _ : state) {
+        state.PauseTiming();
+        v.assign(src.begin(), src.end());
+        state.ResumeTiming();
+        v.remove_indices(indices);
+        benchmark::DoNotOptimize(v.data());
+    }
+    state.SetItemsProcessed(state.iterations() * n);
+}
+BENCHMARK(BM_VectorRemoveIndices)->Arg(4096)->Arg(large)->Arg(large * 8);
+
+void BM_VectorEraseEach(benchmark::State& state) {
+    std::int64_t n = state.range(0);
+    dsa::Vector<int> src = filled(n);
+    dsa::Vector<int> v;
+    for (auto _ : state) {
+        state.PauseTiming();
+        v.assign(src.begin(), src.end());
+        state.ResumeTiming();
+        for (std::int64_t i = (n - 1) / 16 * 16; i >= 0; i -= 16) {
+            v.erase(static_cast<std::size_t>(i));
+        }
+        benchmark::DoNotOptimize(v.data());
+    }
+    state.SetItemsProcessed(state.iterations() * n);
+}
+BENCHMARK(BM_VectorEraseEach)->Arg(4096)->Arg(large);
+
+void BM_VectorReserve(benchmark::State& state) {
+    std::size_t n = static_cast<std::size_t>(state.range(0));
+    for (auto _ : state) {
+        dsa::Vector<int> v;
+        v.reserve(n);
+        benchmark::DoNotOptimize(v.data());
+    }
+}
+BENCHMARK(BM_VectorReserve)->Range(small, large);
+
+// n zeros: calloc/mmap memory for an empty Vector (untouched pages are
+// never written), then the same buffer written once as a kernel would,
+// against resize_uninitialized + the same write
+void BM_VectorResize(benchmark::State& state) {
+    std::size_t n = static_cast<std::size_t>(state.range(0));
+    for (auto _ : state) {
+        dsa::Vector<int> v;
+        v.resize(n);
+        benchmark::DoNotOptimize(v.data());
+    }
+    state.SetBytesProcessed(state.iterations() * std::int64_t(n) * std::int64_t(sizeof(int)));
+}
+BENCHMARK(BM_VectorResize)->Range(small, large * 64);
+
+void BM_VectorResizeWrite(benchmark::State& state) {
+    std::size_t n = static_cast<std::size_t>(state.range(0));
+    for (auto _ : state) {
+        dsa::Vector<int> v;
+        if (state.range(1) == 0) {
+            v.resize(n);
+        } else {
+            v.resize_uninitialized(n);
+        }
+        for (std::size_t i = 0; i < n; i++) {
+            v[i] = static_cast<int>(i);
+        }
+        benchmark::DoNotOptimize(v.data());
+    }
+    state.SetBytesProcessed(state.iterations() * std::int64_t(n) * std::int64_t(sizeof(int)));
+}
+BENCHMARK(BM_VectorResizeWrite)->ArgsProduct({{4096, large}, {0, 1}});
+
+void BM_VectorCopy(benchmark::State& state) {
+    std::int64_t n = state.range(0);
+    dsa::Vector<int> v = filled(n);
+    for (auto _ : state) {
+        dsa::Vector<int> copy(v);
+        benchmark::DoNotOptimize(copy.data());
+    }
+    state.SetBytesProcessed(state.iterations() * n * std::int64_t(sizeof(int)));
+}
+BENCHMARK(BM_VectorCopy)->Range(small, large);
+
+// move out and back: two moves per iteration, no allocation
+void BM_VectorMove(benchmark::State& state) {
+    dsa::Vector<int> v = filled(state.range(0));
+    for (auto _ : state) {
+        dsa::Vector<int> moved(std::move(v));
+        benchmark::DoNotOptimize(moved.data());
+        v = std::move(moved);
+    }
+    state.SetItemsProcessed(state.iterations() * 2);
+}
+BENCHMARK(BM_VectorMove)->Range(small, large);
+
+void BM_VectorIterate(benchmark::State& state) {
+    std::int64_t n = state.range(0);
+    dsa::Vector<int> v = filled(n);
+    for (auto _ : state) {
+        long long sum = 0;
+        for (int x : v) {
+            sum += x;
+        }
+        benchmark::DoNotOptimize(sum);
+    }
+    state.SetBytesProcessed(state.iterations() * n * std::int64_t(sizeof(int)));
+}
+BENCHMARK(BM_VectorIterate)->Range(small, large);
+
+// a zero matrix on the default resource: calloc memory (memset again
+// when glibc reuses a freed block, as in this loop), and from 64 MiB
+// (4096 x 4096) a fresh mapping whose pages are never touched
+void BM_MatrixConstruct(benchmark::State& state) {
+    int n = static_cast<int>(state.range(0));
+    for (auto _ : state) {
+        dsa::Matrix<float> m(n, n);
+        benchmark::DoNotOptimize(m.data());
+    }
+    state.SetBytesProcessed(state.iterations() * std::int64_t(n) * n * std::int64_t(sizeof(float)));
+}
+BENCHMARK(BM_MatrixConstruct)->Range(16, 2048)->Arg(4096);
+
+// every element once through operator(), row by row
+void BM_MatrixElementAccess(benchmark::State& state) {
+    int n = static_cast<int>(state.range(0));
+    dsa::Matrix<float> m(n, n);
+    for (auto _ : state) {
+        float sum = 0;
+        for (int i = 0; i < n; i++) {
+            for (int j = 0; j < n; j++) {
+                sum += m(i, j);
+            }
+        }
+        benchmark::DoNotOptimize(sum);
+    }
+    state.SetBytesProcessed(state.iterations() * std::int64_t(n) * n * std::int64_t(sizeof(float)));
+}
+BENCHMARK(BM_MatrixElementAccess)->Range(16, 2048);
+
+// c = a + b into an existing matrix: two reads and one write per element
+void BM_MatrixAdd(benchmark::State& state) {
+    int n = static_cast<int>(state.range(0));
+    dsa::Matrix<float> a(n, n);
+    dsa::Matrix<float> b(n, n);
+    dsa::Matrix<float> c(n, n);
+    for (auto _ : state) {
+        c = a + b;
+        benchmark::DoNotOptimize(c.data());
+    }
+    state.SetBytesProcessed(state.iterations() * 3 * std::int64_t(n) * n * std::int64_t(sizeof(float)));
+}
+BENCHMARK(BM_MatrixAdd)->Range(16, 2048);
+
+} // namespace
+
+BENCHMARK_MAIN();
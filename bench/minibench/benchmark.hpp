@@ -0,0 +1,552 @@
+#pragma once
+
+// minibench - a small, self-contained microbenchmark harness.
+//
+// The API is a subset of Google Benchmark's, so a suite written against
+// it moves to the real library by changing the include:
+//
+//     static void BM_PushBack(benchmark::State& state) {
+//         for (auto _ : state) {
+//             ...
+//             benchmark::DoNotOptimize(v.data());
+//         }
+//         state.SetBytesProcessed(state.iterations() * bytes_per_iteration);
+//     }
+//     BENCHMARK(BM_PushBack)->Range(8, 8 << 10);
+//     BENCHMARK_MAIN();
+//
+// Each benchmark/argument pair is rerun with a growing iteration count
+// until one run takes at least --benchmark_min_time; that run is
+// reported as time per iteration (ns/op), plus bytes/s and items/s when
+// the benchmark sets them.
+//
+// Command line:
+//     --benchmark_filter=<regex>      run only benchmarks whose name matches
+//     --benchmark_min_time=<seconds>  default 0.2
+//     --benchmark_format=console|json what goes to stdout
+//     --benchmark_out=<file>          also write the results as JSON
+//     --benchmark_compare=<file>      show the change in time against a
+//                                     JSON file from an earlier run
+// The JSON has Google Benchmark's layout ("context", then "benchmarks"
+// with name, iterations, real_time, cpu_time, time_unit,
+// bytes_per_second, items_per_second), so its tools read it too.
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <fstream>
+#include <initializer_list>
+#include <map>
+#include <memory>
+#include <regex>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace benchmark {
+
+// keep value (and everything it points to) alive and unknown to the optimizer
+#if defined(__GNUC__) || defined(__clang__)
+template <typename T>
+inline void DoNotOptimize(const T& value) {
+    asm volatile("" : : "r,m"(value) : "memory");
+}
+
+template <typename T>
+inline void DoNotOptimize(T& value) {
+    asm volatile("" : "+m,r"(value) : : "memory");
+}
+
+// all pending writes to memory happen here
+inline void ClobberMemory() {
+    asm volatile("" : : : "memory");
+}
+#else
+namespace internal {
+inline void use_address(const volatile void*) {}
+} // namespace internal
+
+template <typename T>
+inline void DoNotOptimize(const T& value) {
+    internal::use_address(&value);
+    std::atomic_signal_fence(std::memory_order_seq_cst);
+}
+
+inline void ClobberMemory() {
+    std::atomic_signal_fence(std::memory_order_seq_cst);
+}
+#endif
+
+class State {
+private:
+    using clock = std::chrono::steady_clock;
+
+    std::int64_t max_iterations;
+    std::vector<std::int64_t> args;
+    bool running{false};
+    clock::time_point real_start{};
+    std::clock_t cpu_start{};
+    double real_ns{0};
+    double cpu_ns{0};
+    std::int64_t bytes{0};
+    std::int64_t items{0};
+    std::string text;
+
+    void start() {
+        running = true;
+        real_start = clock::now();
+        cpu_start = std::clock();
+    }
+
+    void stop() {
+        if (!running) {
+            return;
+        }
+        std::chrono::duration<double, std::nano> d = clock::now() - real_start;
+        real_ns += d.count();
+        cpu_ns += double(std::clock() - cpu_start) * 1e9 / CLOCKS_PER_SEC;
+        running = false;
+    }
+
+public:
+    State(std::int64_t iterations, std::vector<std::int64_t> arguments)
+        : max_iterations(iterations), args(std::move(arguments)) {}
+
+    // for (auto _ : state) runs the body iterations() times, timed
+    // [[maybe_unused]] on the type covers every loop variable of it
+    struct [[maybe_unused]] Value {};
+
+    class Iterator {
+    private:
+        State* parent{nullptr};
+        std::int64_t remaining{0};
+
+    public:
+        Iterator() = default;
+        Iterator(State* s, std::int64_t n) : parent(s), remaining(n) {}
+
+        Value operator*() const {
+            return {};
+        }
+
+        Iterator& operator++() {
+            remaining--;
+            return *this;
+        }
+
+        // the timer stops when the loop ends
+        bool operator!=(const Iterator&) {
+            if (remaining != 0) {
+                return true;
+            }
+            parent->stop();
+            return false;
+        }
+    };
+
+    Iterator begin() {
+        start();
+        return Iterator(this, max_iterations);
+    }
+
+    Iterator end() {
+        return Iterator();
+    }
+
+    // exclude setup or cleanup inside the loop from the timing
+    void PauseTiming() {
+        stop();
+    }
+
+    void ResumeTiming() {
+        start();
+    }
+
+    std::int64_t iterations() const {
+        return max_iterations;
+    }
+
+    // i-th argument of this run
+    std::int64_t range(std::size_t i = 0) const {
+        return args.at(i);
+    }
+
+    // totals over all iterations
+    void SetBytesProcessed(std::int64_t n) {
+        bytes = n;
+    }
+
+    void SetItemsProcessed(std::int64_t n) {
+        items = n;
+    }
+
+    void SetLabel(const std::string& label) {
+        text = label;
+    }
+
+    friend struct Run;
+};
+
+using Function = void (*)(State&);
+
+// one reported result
+struct Run {
+    std::string name;
+    std::int64_t iterations{0};
+    double real_ns{0}; // per iteration
+    double cpu_ns{0};
+    double bytes_per_second{0};
+    double items_per_second{0};
+    std::string label;
+
+    Run(std::string n, const State& s) : name(std::move(n)), iterations(s.max_iterations), label(s.text) {
+        real_ns = s.real_ns / double(iterations);
+        cpu_ns = s.cpu_ns / double(iterations);
+        double seconds = s.real_ns / 1e9;
+        if (seconds > 0) {
+            bytes_per_second = double(s.bytes) / seconds;
+            items_per_second = double(s.items) / seconds;
+        }
+    }
+};
+
+class Benchmark {
+private:
+    std::string base;
+    Function fn;
+    std::vector<std::vector<std::int64_t>> arg_sets;
+    int multiplier{8};
+
+    // lo, then powers of the multiplier strictly between, then hi
+    std::vector<std::int64_t> range_values(std::int64_t lo, std::int64_t hi) const {
+        std::vector<std::int64_t> values{lo};
+        for (std::int64_t v = 1; v < hi; v *= multiplier) {
+            if (v > lo) {
+                values.push_back(v);
+            }
+        }
+        if (hi != lo) {
+            values.push_back(hi);
+        }
+        return values;
+    }
+
+public:
+    Benchmark(std::string name, Function f) : base(std::move(name)), fn(f) {}
+
+    Benchmark* Arg(std::int64_t x) {
+        arg_sets.push_back({x});
+        return this;
+    }
+
+    Benchmark* Args(const std::vector<std::int64_t>& xs) {
+        arg_sets.push_back(xs);
+        return this;
+    }
+
+    Benchmark* RangeMultiplier(int m) {
+        multiplier = m;
+        return this;
+    }
+
+    Benchmark* Range(std::int64_t lo, std::int64_t hi) {
+        for (std::int64_t v : range_values(lo, hi)) {
+            arg_sets.push_back({v});
+        }
+        return this;
+    }
+
+    // every combination of one value from each list
+    Benchmark* ArgsProduct(const std::vector<std::vector<std::int64_t>>& lists) {
+        std::vector<std::vector<std::int64_t>> product{{}};
+        for (const auto& list : lists) {
+            std::vector<std::vector<std::int64_t>> next;
+            for (const auto& prefix : product) {
+                for (std::int64_t v : list) {
+                    next.push_back(prefix);
+                    next.back().push_back(v);
+                }
+            }
+            product = std::move(next);
+        }
+        for (auto& args : product) {
+            arg_sets.push_back(std::move(args));
+        }
+        return this;
+    }
+
+    const std::string& name() const {
+        return base;
+    }
+
+    Function function() const {
+        return fn;
+    }
+
+    // no arguments registered: one run without any
+    std::vector<std::vector<std::int64_t>> runs() const {
+        if (arg_sets.empty()) {
+            return {{}};
+        }
+        return arg_sets;
+    }
+};
+
+namespace internal {
+
+inline std::vector<std::unique_ptr<Benchmark>>& registry() {
+    static std::vector<std::unique_ptr<Benchmark>> benchmarks;
+    return benchmarks;
+}
+
+struct Options {
+    std::string filter{"."};
+    double min_time{0.2};
+    bool json{false};
+    std::string out;
+    std::string compare;
+};
+
+inline Options& options() {
+    static Options opts;
+    return opts;
+}
+
+inline std::string run_name(const std::string& base, const std::vector<std::int64_t>& args) {
+    std::string name = base;
+    for (std::int64_t a : args) {
+        name += "/" + std::to_string(a);
+    }
+    return name;
+}
+
+// rerun with more iterations until one run lasts min_time
+inline Run measure(const std::string& name, Function fn, const std::vector<std::int64_t>& args,
+                   double min_time) {
+    std::int64_t iterations = 1;
+    for (;;) {
+        State state(iterations, args);
+        fn(state);
+        Run run(name, state);
+        double seconds = run.real_ns * double(iterations) / 1e9;
+        if (seconds >= min_time || iterations >= 1000000000) {
+            return run;
+        }
+        // aim 40% past min_time, grow at most 100x per step
+        double factor = seconds > 0 ? min_time * 1.4 / seconds : 100.0;
+        factor = factor > 100.0 ? 100.0 : factor;
+        std::int64_t next = static_cast<std::int64_t>(double(iterations) * factor);
+        iterations = next > iterations ? next : iterations + 1;
+    }
+}
+
+inline std::string human(double per_second, const char* unit) {
+    const char* prefixes[] = {"", "k", "M", "G", "T"};
+    int p = 0;
+    while (per_second >= 1000 && p < 4) {
+        per_second /= 1000;
+        p++;
+    }
+    char buf[48];
+    std::snprintf(buf, sizeof(buf), "%.2f %s%s/s", per_second, prefixes[p], unit);
+    return buf;
+}
+
+inline std::string json_escape(const std::string& s) {
+    std::string out;
+    for (char c : s) {
+        if (c == '"' || c == '\\') {
+            out += '\\';
+        }
+        out += c;
+    }
+    return out;
+}
+
+inline std::string to_json(const std::vector<Run>& results) {
+    std::ostringstream os;
+    char date[64] = "";
+    std::time_t now = std::time(nullptr);
+    std::strftime(date, sizeof(date), "%Y-%m-%dT%H:%M:%S", std::localtime(&now));
+#ifdef NDEBUG
+    const char* build = "release";
+#else
+    const char* build = "debug";
+#endif
+    os << "{\n  \"context\": {\n"
+       << "    \"date\": \"" << date << "\",\n"
+       << "    \"num_cpus\": " << std::thread::hardware_concurrency() << ",\n"
+       << "    \"library_build_type\": \"" << build << "\"\n  },\n"
+       << "  \"benchmarks\": [\n";
+    for (std::size_t i = 0; i < results.size(); i++) {
+        const Run& r = results[i];
+        char times[160];
+        std::snprintf(times, sizeof(times),
+                      "      \"real_time\": %.6g,\n      \"cpu_time\": %.6g,\n",
+                      r.real_ns, r.cpu_ns);
+        os << "    {\n"
+           << "      \"name\": \"" << json_escape(r.name) << "\",\n"
+           << "      \"iterations\": " << r.iterations << ",\n"
+           << times
+           << "      \"time_unit\": \"ns\"";
+        if (r.bytes_per_second > 0) {
+            os << ",\n      \"bytes_per_second\": " << r.bytes_per_second;
+        }
+        if (r.items_per_second > 0) {
+            os << ",\n      \"items_per_second\": " << r.items_per_second;
+        }
+        if (!r.label.empty()) {
+            os << ",\n      \"label\": \"" << json_escape(r.label) << "\"";
+        }
+        os << "\n    }" << (i + 1 < results.size() ? "," : "") << "\n";
+    }
+    os << "  ]\n}\n";
+    return os.str();
+}
+
+// name -> real_time from a JSON file written by to_json (or by Google
+// Benchmark): each "name" is followed by its "real_time"
+inline std::map<std::string, double> read_baseline(const std::string& path) {
+    std::map<std::string, double> times;
+    std::ifstream in(path);
+    if (!in) {
+        std::fprintf(stderr, "cannot read %s\n", path.c_str());
+        return times;
+    }
+    std::stringstream ss;
+    ss << in.rdbuf();
+    std::string text = ss.str();
+    const std::string name_key = "\"name\": \"";
+    const std::string time_key = "\"real_time\": ";
+    std::size_t pos = 0;
+    while ((pos = text.find(name_key, pos)) != std::string::npos) {
+        pos += name_key.size();
+        std::size_t end = text.find('"', pos);
+        std::size_t t = text.find(time_key, end);
+        if (end == std::string::npos || t == std::string::npos) {
+            break;
+        }
+        times[text.substr(pos, end - pos)] = std::strtod(text.c_str() + t + time_key.size(), nullptr);
+        pos = end;
+    }
+    return times;
+}
+
+inline bool parse_flag(const char* arg, const char* flag, std::string& value) {
+    std::size_t n = std::strlen(flag);
+    if (std::strncmp(arg, flag, n) == 0 && arg[n] == '=') {
+        value = arg + n + 1;
+        return true;
+    }
+    return false;
+}
+
+} // namespace internal
+
+inline Benchmark* RegisterBenchmark(const char* name, Function fn) {
+    internal::registry().push_back(std::make_unique<Benchmark>(name, fn));
+    return internal::registry().back().get();
+}
+
+inline void Initialize(int* argc, char** argv) {
+    internal::Options& opts = internal::options();
+    int kept = 1;
+    for (int i = 1; i < *argc; i++) {
+        std::string value;
+        if (internal::parse_flag(argv[i], "--benchmark_filter", value)) {
+            opts.filter = value;
+        } else if (internal::parse_flag(argv[i], "--benchmark_min_time", value)) {
+            opts.min_time = std::strtod(value.c_str(), nullptr);
+        } else if (internal::parse_flag(argv[i], "--benchmark_format", value)) {
+            opts.json = value == "json";
+        } else if (internal::parse_flag(argv[i], "--benchmark_out", value)) {
+            opts.out = value;
+        } else if (internal::parse_flag(argv[i], "--benchmark_compare", value)) {
+            opts.compare = value;
+        } else {
+            argv[kept++] = argv[i];
+        }
+    }
+    *argc = kept;
+}
+
+// runs the registered benchmarks that match the filter; returns how many
+inline std::size_t RunSpecifiedBenchmarks() {
+    const internal::Options& opts = internal::options();
+    std::regex filter(opts.filter);
+    std::map<std::string, double> baseline;
+    if (!opts.compare.empty()) {
+        baseline = internal::read_baseline(opts.compare);
+    }
+    bool console = !opts.json;
+    if (console) {
+        std::printf("%-40s %14s %14s %12s %s\n", "Benchmark", "Time (ns/op)", "CPU (ns/op)",
+                    "Iterations", baseline.empty() ? "" : "  vs baseline");
+        std::printf("%s\n", std::string(100, '-').c_str());
+    }
+    std::vector<Run> results;
+    for (const auto& b : internal::registry()) {
+        for (const auto& args : b->runs()) {
+            std::string name = internal::run_name(b->name(), args);
+            if (!std::regex_search(name, filter)) {
+                continue;
+            }
+            Run r = internal::measure(name, b->function(), args, opts.min_time);
+            results.push_back(r);
+            if (!console) {
+                continue;
+            }
+            std::string extra;
+            auto it = baseline.find(name);
+            if (it != baseline.end() && it->second > 0) {
+                char change[32];
+                std::snprintf(change, sizeof(change), "  %+6.1f%%", (r.real_ns / it->second - 1) * 100);
+                extra += change;
+            }
+            if (r.bytes_per_second > 0) {
+                extra += "  " + internal::human(r.bytes_per_second, "B");
+            }
+            if (r.items_per_second > 0) {
+                extra += "  " + internal::human(r.items_per_second, "items");
+            }
+            if (!r.label.empty()) {
+                extra += "  " + r.label;
+            }
+            std::printf("%-40s %14.2f %14.2f %12lld%s\n", name.c_str(), r.real_ns, r.cpu_ns,
+                        static_cast<long long>(r.iterations), extra.c_str());
+            std::fflush(stdout);
+        }
+    }
+    std::string json = internal::to_json(results);
+    if (opts.json) {
+        std::fputs(json.c_str(), stdout);
+    }
+    if (!opts.out.empty()) {
+        std::ofstream(opts.out) << json;
+    }
+    return results.size();
+}
+
+} // namespace benchmark
+
+#define BENCHMARK_CONCAT_(a, b) a##b
+#define BENCHMARK_CONCAT(a, b) BENCHMARK_CONCAT_(a, b)
+
+// BENCHMARK(fn)->Arg(...)... registers fn before main runs
+#define BENCHMARK(fn)                                                          \
+    static ::benchmark::Benchmark* BENCHMARK_CONCAT(minibench_registered_, __LINE__) = \
+        ::benchmark::RegisterBenchmark(#fn, fn)
+
+#define BENCHMARK_MAIN()                               \
+    int main(int argc, char** argv) {                  \
+        ::benchmark::Initialize(&argc, argv);          \
+        ::benchmark::RunSpecifiedBenchmarks();         \
+        return 0;                                      \
+    }                                                  \
+    int main(int, char**)
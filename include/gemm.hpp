@@ -0,0 +1,247 @@
+#pragma once
+
+#include <algorithm>  // std::min
+#include <cstddef>    // std::size_t
+#include <memory>     // std::unique_ptr
+#include <new>        // std::align_val_t
+#include <type_traits> // std::is_same_v
+#include "thread_pool.hpp"
+
+// General matrix multiply on row-major buffers:
+//     C = alpha * A * B + beta * C
+// with A m x k (row stride lda), B k x n (ldb), C m x n (ldc).
+//
+// The driver follows the usual Goto/BLIS layout: B is packed one
+// kc x nc panel at a time into nr-wide slivers that stay in L1, A one
+// mc x kc block at a time into mr-tall slivers that stay in L2, and an
+// mr x nr register-blocked micro-kernel multiplies one A sliver by one B
+// sliver. float and double use AVX2/FMA or AVX-512 micro-kernels chosen
+// at runtime (src/gemm.cpp); other types, and CPUs without those
+// extensions, use the portable scalar micro-kernel below.
+// gemm_parallel cuts C into row x column tiles and runs one blocked
+// gemm per tile on a ThreadPool.
+
+namespace dsa{
+namespace detail{
+
+// cache blocking of one micro-kernel
+struct GemmBlocking {
+    std::size_t mr;  // micro-tile rows (A sliver height)
+    std::size_t nr;  // micro-tile columns (B sliver width)
+    std::size_t kc;  // depth of a packed panel
+    std::size_t mc;  // rows of a packed A block
+    std::size_t nc;  // columns of a packed B panel
+};
+
+// micro-kernel: c[0..mr)[0..nr) = alpha * a_sliver * b_sliver + beta * c
+// a holds kc groups of mr values, b holds kc groups of nr values; when
+// beta == 0, c is only written
+template <typename T>
+using GemmKernel = void (*)(std::size_t kc, const T* a, const T* b, T* c, std::size_t ldc,
+                            T alpha, T beta);
+
+// 64-byte aligned scratch for the packed panels
+template <typename T>
+struct AlignedDelete {
+    void operator()(T* p) const {
+        ::operator delete(p, std::align_val_t(64));
+    }
+};
+
+template <typename T>
+std::unique_ptr<T, AlignedDelete<T>> aligned_buffer(std::size_t n) {
+    return std::unique_ptr<T, AlignedDelete<T>>(
+        static_cast<T*>(::operator new(n * sizeof(T), std::align_val_t(64))));
+}
+
+// portable micro-kernel; MR x NR accumulators the compiler can keep in
+// registers and vectorize along NR
+template <typename T, std::size_t MR, std::size_t NR>
+void gemm_kernel_scalar(std::size_t kc, const T* a, const T* b, T* c, std::size_t ldc,
+                        T alpha, T beta) {
+    T acc[MR][NR] = {};
+    for (std::size_t p = 0; p < kc; p++) {
+        for (std::size_t i = 0; i < MR; i++) {
+            T ai = a[p * MR + i];
+            for (std::size_t j = 0; j < NR; j++) {
+                acc[i][j] += ai * b[p * NR + j];
+            }
+        }
+    }
+    for (std::size_t i = 0; i < MR; i++) {
+        for (std::size_t j = 0; j < NR; j++) {
+            T v = static_cast<T>(alpha * acc[i][j]);
+            c[i * ldc + j] = (beta == T(0)) ? v : static_cast<T>(v + beta * c[i * ldc + j]);
+        }
+    }
+}
+
+// pack rows [0, mc) x columns [0, kc) of A into mr-tall slivers, k-major
+// inside each sliver; rows past mc are zero padded
+template <typename T>
+void gemm_pack_a(std::size_t mc, std::size_t kc, const T* a, std::size_t lda,
+                 std::size_t mr, T* out) {
+    for (std::size_t i0 = 0; i0 < mc; i0 += mr) {
+        std::size_t rows = std::min(mr, mc - i0);
+        for (std::size_t p = 0; p < kc; p++) {
+            for (std::size_t i = 0; i < rows; i++) {
+                out[i] = a[(i0 + i) * lda + p];
+            }
+            for (std::size_t i = rows; i < mr; i++) {
+                out[i] = T(0);
+            }
+            out += mr;
+        }
+    }
+}
+
+// pack rows [0, kc) x columns [0, nc) of B into nr-wide slivers, k-major
+// inside each sliver; columns past nc are zero padded
+template <typename T>
+void gemm_pack_b(std::size_t kc, std::size_t nc, const T* b, std::size_t ldb,
+                 std::size_t nr, T* out) {
+    for (std::size_t j0 = 0; j0 < nc; j0 += nr) {
+        std::size_t cols = std::min(nr, nc - j0);
+        for (std::size_t p = 0; p < kc; p++) {
+            const T* row = b + p * ldb + j0;
+            for (std::size_t j = 0; j < cols; j++) {
+                out[j] = row[j];
+            }
+            for (std::size_t j = cols; j < nr; j++) {
+                out[j] = T(0);
+            }
+            out += nr;
+        }
+    }
+}
+
+// blocked driver around one micro-kernel
+template <typename T>
+void gemm_blocked(std::size_t m, std::size_t n, std::size_t k, T alpha,
+                  const T* a, std::size_t lda, const T* b, std::size_t ldb,
+                  T beta, T* c, std::size_t ldc,
+                  GemmKernel<T> kernel, const GemmBlocking& blk) {
+    if (m == 0 || n == 0) {
+        return;
+    }
+    if (k == 0 || alpha == T(0)) {
+        for (std::size_t i = 0; i < m; i++) {
+            for (std::size_t j = 0; j < n; j++) {
+                c[i * ldc + j] = (beta == T(0)) ? T(0) : static_cast<T>(beta * c[i * ldc + j]);
+            }
+        }
+        return;
+    }
+
+    std::size_t nc_max = std::min(blk.nc, (n + blk.nr - 1) / blk.nr * blk.nr);
+    std::size_t mc_max = std::min(blk.mc, (m + blk.mr - 1) / blk.mr * blk.mr);
+    std::size_t kc_max = std::min(blk.kc, k);
+    auto packed_b = aligned_buffer<T>(kc_max * nc_max);
+    auto packed_a = aligned_buffer<T>(kc_max * mc_max);
+    auto edge = aligned_buffer<T>(blk.mr * blk.nr);
+
+    for (std::size_t jc = 0; jc < n; jc += blk.nc) {
+        std::size_t nc = std::min(blk.nc, n - jc);
+        for (std::size_t pc = 0; pc < k; pc += blk.kc) {
+            std::size_t kc = std::min(blk.kc, k - pc);
+            // beta applies to C once, on the first pass over k
+            T beta_pass = (pc == 0) ? beta : T(1);
+            gemm_pack_b(kc, nc, b + pc * ldb + jc, ldb, blk.nr, packed_b.get());
+
+            for (std::size_t ic = 0; ic < m; ic += blk.mc) {
+                std::size_t mc = std::min(blk.mc, m - ic);
+                gemm_pack_a(mc, kc, a + ic * lda + pc, lda, blk.mr, packed_a.get());
+
+                for (std::size_t jr = 0; jr < nc; jr += blk.nr) {
+                    std::size_t cols = std::min(blk.nr, nc - jr);
+                    const T* b_sliver = packed_b.get() + jr * kc;
+                    for (std::size_t ir = 0; ir < mc; ir += blk.mr) {
+                        std::size_t rows = std::min(blk.mr, mc - ir);
+                        const T* a_sliver = packed_a.get() + ir * kc;
+                        T* c_tile = c + (ic + ir) * ldc + jc + jr;
+                        if (rows == blk.mr && cols == blk.nr) {
+                            kernel(kc, a_sliver, b_sliver, c_tile, ldc, alpha, beta_pass);
+                            continue;
+                        }
+                        // partial tile: compute a full one aside, copy the valid part
+                        kernel(kc, a_sliver, b_sliver, edge.get(), blk.nr, alpha, T(0));
+                        for (std::size_t i = 0; i < rows; i++) {
+                            for (std::size_t j = 0; j < cols; j++) {
+                                T v = edge.get()[i * blk.nr + j];
+                                T& out = c_tile[i * ldc + j];
+                                out = (beta_pass == T(0)) ? v : static_cast<T>(v + beta_pass * out);
+                            }
+                        }
+                    }
+                }
+            }
+        }
+    }
+}
+
+// SIMD drivers for float and double with runtime ISA dispatch
+// (defined in src/gemm.cpp)
+void gemm_f32(std::size_t m, std::size_t n, std::size_t k, float alpha,
+              const float* a, std::size_t lda, const float* b, std::size_t ldb,
+              float beta, float* c, std::size_t ldc);
+void gemm_f64(std::size_t m, std::size_t n, std::size_t k, double alpha,
+              const double* a, std::size_t lda, const double* b, std::size_t ldb,
+              double beta, double* c, std::size_t ldc);
+
+// name of the micro-kernel gemm_f32/gemm_f64 dispatch to on this CPU:
+// "avx512", "avx2" or "scalar"
+const char* gemm_isa();
+
+// C = alpha * A * B + beta * C for any arithmetic T
+template <typename T>
+void gemm(std::size_t m, std::size_t n, std::size_t k, T alpha,
+          const T* a, std::size_t lda, const T* b, std::size_t ldb,
+          T beta, T* c, std::size_t ldc) {
+    if constexpr (std::is_same_v<T, float>) {
+        gemm_f32(m, n, k, alpha, a, lda, b, ldb, beta, c, ldc);
+    } else if constexpr (std::is_same_v<T, double>) {
+        gemm_f64(m, n, k, alpha, a, lda, b, ldb, beta, c, ldc);
+    } else {
+        constexpr GemmBlocking blk{4, 8, 256, 128, 4096};
+        gemm_blocked<T>(m, n, k, alpha, a, lda, b, ldb, beta, c, ldc,
+                        &gemm_kernel_scalar<T, 4, 8>, blk);
+    }
+}
+
+// gemm split into tiles of C over pool; each tile packs its own panels,
+// which costs k*(tile rows + tile cols) copies against
+// k*tile rows*tile cols multiply-adds
+template <typename T>
+void gemm_parallel(ThreadPool& pool, std::size_t m, std::size_t n, std::size_t k, T alpha,
+                   const T* a, std::size_t lda, const T* b, std::size_t ldb,
+                   T beta, T* c, std::size_t ldc) {
+    std::size_t threads = pool.size();
+    // below ~64^3 multiply-adds the hand-off costs more than it saves
+    if (threads <= 1 || m * n * k < (std::size_t(1) << 18)) {
+        gemm<T>(m, n, k, alpha, a, lda, b, ldb, beta, c, ldc);
+        return;
+    }
+    // about four tiles per thread for balance; at least 48 rows and 256
+    // columns per tile so the packed panels are still worth building
+    std::size_t target = 4 * threads;
+    std::size_t row_tiles = std::max<std::size_t>(1, std::min(target, m / 48));
+    std::size_t col_tiles = std::max<std::size_t>(
+        1, std::min((target + row_tiles - 1) / row_tiles, n / 256));
+    // tile edges on micro-tile multiples (12 rows, 32 columns cover all kernels)
+    std::size_t mb = ((m + row_tiles - 1) / row_tiles + 11) / 12 * 12;
+    std::size_t nb = ((n + col_tiles - 1) / col_tiles + 31) / 32 * 32;
+    row_tiles = (m + mb - 1) / mb;
+    col_tiles = (n + nb - 1) / nb;
+
+    pool.parallel_for(row_tiles * col_tiles, 1, [&](std::size_t first, std::size_t last) {
+        for (std::size_t t = first; t < last; t++) {
+            std::size_t i0 = t / col_tiles * mb;
+            std::size_t j0 = t % col_tiles * nb;
+            gemm<T>(std::min(mb, m - i0), std::min(nb, n - j0), k, alpha,
+                    a + i0 * lda, lda, b + j0, ldb, beta, c + i0 * ldc + j0, ldc);
+        }
+    });
+}
+
+}//end namespace detail
+}//end namespace dsa
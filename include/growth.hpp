@@ -0,0 +1,129 @@
+#pragma once
+
+#include <algorithm>  // std::max
+#include <cstddef>    // std::size_t
+#include <limits>     // std::numeric_limits
+
+namespace dsa{
+
+// Growth policies decide the next capacity when a Vector is full.
+// A policy is any default-constructible callable taking the current
+// capacity, and optionally sizeof(T), and returning the new capacity:
+//     std::size_t operator()(std::size_t cap) const;
+//     std::size_t operator()(std::size_t cap, std::size_t elem_size) const;
+// Vector never grows by less than one slot, whatever the policy returns,
+// and clamps the result to its max_size(). The built-in policies saturate
+// at the largest std::size_t instead of wrapping around.
+
+namespace detail{
+
+inline constexpr std::size_t size_max = std::numeric_limits<std::size_t>::max();
+
+// a * b, or size_max if that overflows
+constexpr std::size_t saturating_mul(std::size_t a, std::size_t b) {
+    return (b != 0 && a > size_max / b) ? size_max : a * b;
+}
+
+// a + b, or size_max if that overflows
+constexpr std::size_t saturating_add(std::size_t a, std::size_t b) {
+    return (a > size_max - b) ? size_max : a + b;
+}
+
+}//end namespace detail
+
+// max(1, 2*cap) - the default, amortized O(1) push_back
+struct DoublingGrowth {
+    std::size_t operator()(std::size_t cap) const {
+        return std::max<std::size_t>(1, detail::saturating_mul(2, cap));
+    }
+};
+
+// max(1, cap*Num/Den); 3/2 lets the allocator reuse the blocks freed by
+// earlier growth steps, which doubling never fits into
+template <std::size_t Num, std::size_t Den>
+struct FactorGrowth {
+    static_assert(Num > Den, "growth factor must be greater than 1");
+
+    std::size_t operator()(std::size_t cap) const {
+        std::size_t next = detail::saturating_add(detail::saturating_mul(cap / Den, Num),
+                                                  cap % Den * Num / Den);
+        return std::max<std::size_t>(detail::saturating_add(cap, 1), next);
+    }
+};
+
+using OneAndHalfGrowth = FactorGrowth<3, 2>;
+
+// cap + Step - bounded slack for memory-tight vectors, O(n) push_back
+template <std::size_t Step>
+struct ChunkGrowth {
+    static_assert(Step > 0, "growth step must be positive");
+
+    std::size_t operator()(std::size_t cap) const {
+        return detail::saturating_add(cap, Step);
+    }
+};
+
+// doubling, then rounded up so the block fills what the allocator
+// would hand out anyway, as malloc_usable_size reports on glibc:
+//   small blocks: 16-byte chunks less malloc's 8-byte size header, and
+//     never below malloc's smallest chunk of 4 words
+//   heap blocks from a page up: whole pages less that header
+//   blocks glibc serves with mmap (128 KiB and up by default): whole
+//     pages less 3 words - the chunk carries a 2-word header and one
+//     more word must fit, or glibc maps another page
+struct PageRoundedGrowth {
+    static constexpr std::size_t page = 4096;
+    static constexpr std::size_t granule = 16;
+    static constexpr std::size_t header = sizeof(std::size_t);
+    static constexpr std::size_t min_chunk = 4 * sizeof(std::size_t);
+    static constexpr std::size_t mmap_threshold = std::size_t(128) << 10;
+    static constexpr std::size_t mmap_header = 3 * sizeof(std::size_t);
+
+    std::size_t operator()(std::size_t cap, std::size_t elem_size) const {
+        std::size_t count = std::max<std::size_t>(1, detail::saturating_mul(2, cap));
+        std::size_t bytes = detail::saturating_mul(count, elem_size);
+        if (bytes > detail::size_max - mmap_header - page) {
+            return count;
+        }
+        std::size_t unit = bytes + header >= page ? page : granule;
+        std::size_t block = std::max(min_chunk, round_up(bytes + header, unit));
+        if (block >= mmap_threshold) {
+            block = round_up(bytes + mmap_header, page);
+            return (block - mmap_header) / elem_size;
+        }
+        return (block - header) / elem_size;
+    }
+
+private:
+    static constexpr std::size_t round_up(std::size_t bytes, std::size_t unit) {
+        return (bytes + unit - 1) / unit * unit;
+    }
+};
+
+// When a Vector gives capacity back. pop_back and erase only shrink in
+// automatic mode; shrink() and shrink_to_fit() also run in explicit mode;
+// in never mode capacity only ever grows. Shrinking happens once
+// size <= capacity / trigger_divisor and leaves capacity / shrink_divisor
+// slots. The gap between the two divisors is the hysteresis band that
+// keeps a size oscillating near the boundary from reallocating each time.
+struct ShrinkPolicy {
+    enum class Mode : unsigned char { automatic, explicit_only, never };
+
+    Mode mode{Mode::automatic};
+    unsigned short trigger_divisor{4};
+    unsigned short shrink_divisor{2};
+
+    static constexpr ShrinkPolicy never() {
+        return ShrinkPolicy{Mode::never, 4, 2};
+    }
+
+    static constexpr ShrinkPolicy explicit_only() {
+        return ShrinkPolicy{Mode::explicit_only, 4, 2};
+    }
+
+    static constexpr ShrinkPolicy automatic(unsigned short trigger = 4, unsigned short shrink = 2) {
+        return ShrinkPolicy{Mode::automatic, trigger, shrink};
+    }
+};
+
+}//end namespace dsa
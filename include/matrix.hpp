@@ -1,15 +1,178 @@
 #pragma once
 
+#include "gemm.hpp"
+#include "matrix_expr.hpp"
+#include "thread_pool.hpp"
+#include "transpose.hpp"
 #include "vector.hpp"
-#include <stdexcept>  // std::out_of_range
+#include <algorithm>  // std::min, std::max
+#include <cstddef>    // std::size_t
+#include <memory_resource> // std::pmr::memory_resource
+#include <span>       // std::span
+#include <stdexcept>  // std::out_of_range, std::invalid_argument
+#include <type_traits> // std::is_arithmetic_v, std::is_integral_v, std::type_identity_t
+#include <utility>    // std::move
+
+// Nonzero: Matrix::operator() and row() check their indices and throw
+// std::out_of_range. Defaults to on in debug builds (NDEBUG not defined)
+// and off otherwise; at() always checks, unchecked() never does.
+#ifndef DSA_MATRIX_CHECKED
+#ifdef NDEBUG
+#define DSA_MATRIX_CHECKED 0
+#else
+#define DSA_MATRIX_CHECKED 1
+#endif
+#endif
 
 namespace dsa{
 
+template <typename T>
+class Matrix;
+
+template <typename T>
+void gemm(std::type_identity_t<T> alpha, const Matrix<T>& A, const Matrix<T>& B,
+          std::type_identity_t<T> beta, Matrix<T>& C);
+
+// rows x cols matrix of T in one contiguous row-major buffer:
+// element (i, j) is data[i * stride + j]
+// Supported element types: float, double, int8_t, int16_t, int, int64_t.
+// T defaults to int, so dsa::Matrix<> and a plain dsa::Matrix m(r, c)
+// (class template argument deduction) are the int matrix.
+// +, - and scalar * are lazy and fuse into one pass (matrix_expr.hpp);
+// * between matrices, transpose() and gemm() compute right away.
+// Thread safety: const member functions, and the operators, which only
+// read their operands, touch no state but the matrix's own elements and
+// the internally synchronized thread pool. Any number of threads may
+// read one Matrix concurrently (element access, row spans, +, -, *,
+// transpose(), gemm() with it as A or B) as long as none writes it;
+// writes need external synchronization, as with the standard containers.
+template <typename T = int>
 class Matrix {
+    static_assert(std::is_arithmetic_v<T>, "Matrix elements must be arithmetic");
+
 private:
-    int rows{0};
-    int cols{0};
-    dsa::Vector<dsa::Vector<int>> data;
+    int nrows{0};
+    int ncols{0};
+    std::size_t row_stride{0}; // elements from one row to the next
+    // a single allocation from one memory resource, so a request-scoped
+    // Matrix can live in a monotonic arena (the default resource is
+    // swapped for zeroed memory, see storage_resource)
+    dsa::pmr::Vector<T> elems;
+
+    // offset of (i, j) in data, no bounds check
+    std::size_t offset(int i, int j) const {
+        return static_cast<std::size_t>(i) * row_stride + static_cast<std::size_t>(j);
+    }
+
+    void check_index(int i, int j) const {
+        if (i < 0 || i >= nrows || j < 0 || j >= ncols) {
+            throw std::out_of_range("Invalid Index");
+        }
+    }
+
+    void check_row(int i) const {
+        if (i < 0 || i >= nrows) {
+            throw std::out_of_range("Invalid Index");
+        }
+    }
+
+    // f(k) for k in [begin, end). Whole blocks of 16 first: -O2's
+    // vectorizer only takes loops that need no alias checks and no
+    // remainder loop, which a fixed-length block marked ivdep is. Every
+    // f used here touches only element k, so there are no loop-carried
+    // dependencies even when the destination is also an operand.
+    template <typename F>
+    static void for_each_index(std::size_t begin, std::size_t end, F f) {
+        constexpr std::size_t block = 16;
+        std::size_t k = begin;
+        for (; k + block <= end; k += block) {
+#pragma GCC ivdep
+            for (std::size_t u = 0; u < block; u++) {
+                f(k + u);
+            }
+        }
+        for (; k < end; k++) {
+            f(k);
+        }
+    }
+
+    // f(r0, r1) over bands of 64 rows covering [0, rows), spread over the
+    // shared pool; a band stays on one thread
+    template <typename F>
+    void for_each_band(F f) const {
+        constexpr std::size_t band = 64;
+        std::size_t r = static_cast<std::size_t>(nrows);
+        std::size_t c = std::max<std::size_t>(1, static_cast<std::size_t>(ncols));
+        std::size_t bands = (r + band - 1) / band;
+        std::size_t band_grain = std::max<std::size_t>(1, parallel::grain() / (band * c));
+        parallel::pool().parallel_for(bands, band_grain, [&](std::size_t first, std::size_t last) {
+            for (std::size_t b = first; b < last; b++) {
+                f(b * band, std::min(r, (b + 1) * band));
+            }
+        });
+    }
+
+    // data[k] = e[k] for every k, one fused pass in grain-sized pieces on
+    // the shared pool; e has this matrix's shape
+    template <typename E>
+    void evaluate(const E& e) {
+        T* out = elems.data();
+        parallel::for_range(elems.size(), [out, &e](std::size_t begin, std::size_t end) {
+            for_each_index(begin, end, [out, &e](std::size_t k) { out[k] = e[k]; });
+        });
+    }
+
+    // data[k] = op(data[k], e[k]) in place, same split as evaluate
+    template <typename E, typename Op>
+    void update(const E& e, Op op) {
+        if (e.rows() != nrows || e.cols() != ncols) {
+            throw std::out_of_range("Dimensions must match");
+        }
+        T* out = elems.data();
+        parallel::for_range(elems.size(), [out, &e, op](std::size_t begin, std::size_t end) {
+            for_each_index(begin, end, [out, &e, op](std::size_t k) { out[k] = op(out[k], e[k]); });
+        });
+    }
+
+    // data[k] = op(data[k]) in place
+    template <typename Op>
+    void update(Op op) {
+        T* out = elems.data();
+        parallel::for_range(elems.size(), [out, op](std::size_t begin, std::size_t end) {
+            for_each_index(begin, end, [out, op](std::size_t k) { out[k] = op(out[k]); });
+        });
+    }
+
+    // where the elements of a matrix asked to live in mr really go:
+    // new_delete_resource() (the default) is swapped for the zeroed
+    // calloc/mmap resource, so a fresh zero matrix needs no fill pass
+    // and its untouched pages are never backed by the OS
+    static std::pmr::memory_resource* storage_resource(std::pmr::memory_resource* mr) {
+        return mr == std::pmr::new_delete_resource() ? detail::zeroed_resource() : mr;
+    }
+
+    // tag for the private constructor below
+    struct Uninitialized {};
+
+    // rows x cols with the elements left unwritten, for results that a
+    // kernel or an evaluate pass overwrites whole (transpose, *, lazy
+    // expressions): they skip the zeroing pass
+    Matrix(int r, int c, std::pmr::memory_resource* mr, Uninitialized)
+        : elems(storage_resource(mr)) {
+        elems.resize_uninitialized(set_shape(r, c));
+    }
+
+    // if r < 0 OR c < 0 throw std::out_of_range("Negative dimensions")
+    // take the shape r x c (stride = cols), return rows*stride
+    std::size_t set_shape(int r, int c) {
+        if (r < 0 || c < 0) {
+            throw std::out_of_range("Negative dimensions");
+        }
+        nrows = r;
+        ncols = c;
+        row_stride = static_cast<std::size_t>(ncols);
+        return static_cast<std::size_t>(nrows) * row_stride;
+    }
 
 public:
     /*
@@ -17,52 +180,275 @@ public:
         throw std::out_of_range("Negative dimensions");
     rows = r
     cols = c
-    for i from 0 to rows-1
-        declare row vector of ints
-        for j from 0 to cols-1
-            append 0 to row  // initialize each element with 0
-        append row to data
+    stride = cols
+    rows*stride zeros in one allocation
+      default resource: zeroed calloc/mmap memory, nothing written
+      other resources: Vector::resize, one memset
     */
-    Matrix(int r, int c) {
-        if (r < 0 || c < 0) {
-            throw std::out_of_range("Negative dimensions");
+    Matrix(int r, int c, std::pmr::memory_resource* mr = std::pmr::get_default_resource())
+        : elems(storage_resource(mr)) {
+        std::size_t n = set_shape(r, c);
+        if (elems.get_allocator().resource() == detail::zeroed_resource()) {
+            elems.resize_uninitialized(n);  // a fresh block, zero already
+        } else {
+            elems.resize(n);
+        }
+    }
+
+    // copies allocate from the default resource, as pmr containers do
+    // (swapped like above, so copies and fresh matrices share a resource
+    // and move assignment between them just takes the buffer)
+    Matrix(const Matrix& other)
+        : nrows(other.nrows), ncols(other.ncols), row_stride(other.row_stride),
+          elems(other.elems, std::pmr::polymorphic_allocator<T>(
+                                 storage_resource(std::pmr::get_default_resource()))) {}
+
+    Matrix(Matrix&&) noexcept = default;
+    Matrix& operator=(const Matrix&) = default;
+    Matrix& operator=(Matrix&&) = default;
+    ~Matrix() = default;
+
+    int rows() const {
+        return nrows;
+    }
+
+    int cols() const {
+        return ncols;
+    }
+
+    // elements from the start of one row to the next
+    std::size_t stride() const {
+        return row_stride;
+    }
+
+    // row i is [data() + i * stride(), data() + i * stride() + cols())
+    T* data() {
+        return elems.data();
+    }
+
+    const T* data() const {
+        return elems.data();
+    }
+
+    // if DSA_MATRIX_CHECKED and i or j out of range
+    //throw std::out_of_range("Invalid Index");
+    //data[i * stride + j]
+    T& operator()(int i, int j) {
+#if DSA_MATRIX_CHECKED
+        check_index(i, j);
+#endif
+        return elems[offset(i, j)];
+    }
+
+    const T& operator()(int i, int j) const {
+#if DSA_MATRIX_CHECKED
+        check_index(i, j);
+#endif
+        return elems[offset(i, j)];
+    }
+
+    // if i or j out of range
+    //throw std::out_of_range("Invalid Index");
+    //data[i * stride + j]
+    T& at(int i, int j) {
+        check_index(i, j);
+        return elems[offset(i, j)];
+    }
+
+    const T& at(int i, int j) const {
+        check_index(i, j);
+        return elems[offset(i, j)];
+    }
+
+    // data[i * stride + j], never checked
+    T& unchecked(int i, int j) {
+        return elems[offset(i, j)];
+    }
+
+    const T& unchecked(int i, int j) const {
+        return elems[offset(i, j)];
+    }
+
+    // if DSA_MATRIX_CHECKED and i out of range
+    //throw std::out_of_range("Invalid Index");
+    // the cols() elements of row i; index the span, not the matrix, in
+    // inner loops
+    std::span<T> row(int i) {
+#if DSA_MATRIX_CHECKED
+        check_row(i);
+#endif
+        return std::span<T>(elems.data() + offset(i, 0), static_cast<std::size_t>(ncols));
+    }
+
+    std::span<const T> row(int i) const {
+#if DSA_MATRIX_CHECKED
+        check_row(i);
+#endif
+        return std::span<const T>(elems.data() + offset(i, 0), static_cast<std::size_t>(ncols));
+    }
+
+    // evaluate a lazy +, -, scalar * expression (matrix_expr.hpp) in one
+    // fused pass: result.data[k] = e[k], allocated from e's leftmost
+    // operand's memory resource
+    template <typename E>
+    Matrix(const MatrixExpr<E>& e)
+        : Matrix(e.self().rows(), e.self().cols(), e.self().resource(), Uninitialized{}) {
+        evaluate(e.self());
+    }
+
+    // same, into this matrix; reuses the buffer when the shapes match.
+    // Safe when this matrix is also an operand (a = a + b): element k only
+    // reads the operands' element k
+    template <typename E>
+    Matrix& operator=(const MatrixExpr<E>& e) {
+        const E& expr = e.self();
+        if (expr.rows() == nrows && expr.cols() == ncols) {
+            evaluate(expr);
+            return *this;
         }
-        rows = r;
-        cols = c;
+        Matrix result(expr.rows(), expr.cols(), elems.get_allocator().resource(), Uninitialized{});
+        result.evaluate(expr);
+        *this = std::move(result);
+        return *this;
+    }
 
-        // use reserve for efficiency
-        data.reserve(rows);
+    // In-place accumulation: no allocation, one pass. other may be a
+    // Matrix or a lazy expression (m += a * alpha fuses too), and may
+    // include this matrix.
+    // throw std::out_of_range("Dimensions must match")
+    // data[k] = data[k] + other[k]
+    template <MatrixOperand M>
+    Matrix& operator+=(const M& other) {
+        update(detail::as_expr(other), MatrixAdd{});
+        return *this;
+    }
+
+    // throw std::out_of_range("Dimensions must match")
+    // data[k] = data[k] - other[k]
+    template <MatrixOperand M>
+    Matrix& operator-=(const M& other) {
+        update(detail::as_expr(other), MatrixSub{});
+        return *this;
+    }
+
+    // throw std::out_of_range("Dimensions must match")
+    // data[k] = data[k] * other[k] (Hadamard product); a named method
+    // because m * other, and so m *= other, would mean the matrix product
+    template <MatrixOperand M>
+    Matrix& multiply_elementwise(const M& other) {
+        update(detail::as_expr(other), [](T x, T y) { return static_cast<T>(x * y); });
+        return *this;
+    }
+
+    // data[k] = data[k] * s
+    Matrix& operator*=(T s) {
+        update([s](T x) { return static_cast<T>(x * s); });
+        return *this;
+    }
 
-        for (int i = 0; i < rows; i++) {
-            dsa::Vector<int> row_vec;
-            row_vec.reserve(cols);
-            for (int j = 0; j < cols; j++) {
-                row_vec.push_back(0);
+    // integer matrices: if s == 0 throw std::invalid_argument("Division by zero")
+    // data[k] = data[k] / s
+    Matrix& operator/=(T s) {
+        if constexpr (std::is_integral_v<T>) {
+            if (s == 0) {
+                throw std::invalid_argument("Division by zero");
             }
-            data.push_back(row_vec);
         }
+        update([s](T x) { return static_cast<T>(x / s); });
+        return *this;
     }
 
-    //data.at(i).at(j)
-    int& operator()(int i, int j) {
-        return data.at(i).at(j);
+    // result(j, i) = (i, j), a cols x rows matrix
+    // cache-oblivious recursive blocking with in-register 8x8 / 4x4 tile
+    // transposes for 4-byte types (transpose.hpp); bands of 64 rows go
+    // to the pool
+    Matrix transpose() const {
+        Matrix result(ncols, nrows, elems.get_allocator().resource(), Uninitialized{});
+        const T* src = elems.data();
+        T* dst = result.elems.data();
+        std::size_t c = static_cast<std::size_t>(ncols);
+        for_each_band([&](std::size_t r0, std::size_t r1) {
+            detail::transpose_rows(src, row_stride, dst, result.row_stride, r0, r1, c);
+        });
+        return result;
     }
 
-    // throw std::out_of_range("dimensions must match")
-    // result(i, j) = (*this)(i, j) + other(i, j)
-    Matrix operator+(Matrix& other) {
-        if (rows != other.rows || cols != other.cols) {
-            throw std::out_of_range("Dimensions must match");
+    // (i, j) <-> (j, i)
+    // square: swaps mirror tiles in place, no allocation; otherwise the
+    // shape changes, so this is transpose() into a new buffer
+    void transpose_in_place() {
+        if (nrows != ncols) {
+            *this = transpose();
+            return;
         }
-        Matrix result(rows, cols);
-        for (int i = 0; i < rows; i++) {
-            for (int j = 0; j < cols; j++) {
-                result(i, j) = (*this)(i, j) + other(i, j);
-            }
+        T* a = elems.data();
+        std::size_t n = static_cast<std::size_t>(nrows);
+        for_each_band([&](std::size_t r0, std::size_t r1) {
+            detail::transpose_in_place_rows(a, row_stride, n, r0, r1);
+        });
+    }
+
+    // throw std::out_of_range("Dimensions must match") unless cols == other.rows
+    // result = this * other, a (rows x other.cols) matrix
+    // cache-blocked, packed and vectorized, tiles of result spread over
+    // the shared pool - see gemm.hpp
+    Matrix operator*(const Matrix& other) const {
+        if (ncols != other.nrows) {
+            throw std::out_of_range("Dimensions must match");
         }
-        return result; // think why - ans for chaining
+        // gemm with beta == 0 only writes C
+        Matrix result(nrows, other.ncols, elems.get_allocator().resource(), Uninitialized{});
+        gemm<T>(T(1), *this, other, T(0), result);
+        return result;
     }
 
+    friend class MatrixRef<T>;
+
+    template <typename U>
+    friend void gemm(std::type_identity_t<U> alpha, const Matrix<U>& A, const Matrix<U>& B,
+                     std::type_identity_t<U> beta, Matrix<U>& C);
 };
 
+template <typename E>
+Matrix(const MatrixExpr<E>&) -> Matrix<typename E::value_type>;
+
+// matrix products with an expression operand: the expression is
+// evaluated into a Matrix (one fused pass), then multiplied as above
+// throw std::out_of_range("Dimensions must match") unless cols == other.rows
+template <typename E, typename T>
+Matrix<T> operator*(const MatrixExpr<E>& e, const Matrix<T>& m) {
+    return e.eval() * m;
+}
+
+template <typename T, typename E>
+Matrix<T> operator*(const Matrix<T>& m, const MatrixExpr<E>& e) {
+    return m * e.eval();
+}
+
+template <typename E1, typename E2>
+auto operator*(const MatrixExpr<E1>& l, const MatrixExpr<E2>& r) {
+    return l.eval() * r.eval();
+}
+
+template <typename T>
+MatrixRef<T>::MatrixRef(const Matrix<T>& m)
+    : elems(m.elems.data()), nrows(m.nrows), ncols(m.ncols), mr(m.elems.get_allocator().resource()) {}
+
+// C = alpha * A * B + beta * C
+// throw std::out_of_range("Dimensions must match") unless
+//     A.cols == B.rows, C.rows == A.rows and C.cols == B.cols
+// C is not read when beta == 0; C must not share storage with A or B
+template <typename T>
+void gemm(std::type_identity_t<T> alpha, const Matrix<T>& A, const Matrix<T>& B,
+          std::type_identity_t<T> beta, Matrix<T>& C) {
+    if (A.ncols != B.nrows || C.nrows != A.nrows || C.ncols != B.ncols) {
+        throw std::out_of_range("Dimensions must match");
+    }
+    detail::gemm_parallel<T>(parallel::pool(),
+                             static_cast<std::size_t>(A.nrows), static_cast<std::size_t>(B.ncols),
+                             static_cast<std::size_t>(A.ncols), alpha,
+                             A.elems.data(), A.row_stride, B.elems.data(), B.row_stride,
+                             beta, C.elems.data(), C.row_stride);
+}
+
 }
@@ -0,0 +1,173 @@
+#pragma once
+
+#include <cstddef>    // std::size_t
+#include <memory_resource> // std::pmr::memory_resource
+#include <stdexcept>  // std::out_of_range
+#include <type_traits> // std::is_same_v, std::remove_cvref_t
+#include <utility>    // std::declval
+
+// Lazy elementwise Matrix arithmetic.
+// +, - and scalar * on matrices return small expression nodes instead of
+// a new Matrix. Assigning a node to a Matrix (or constructing one from
+// it) evaluates the whole tree in a single fused loop:
+//     Matrix<float> r = a + b + c + d;   // one pass, one allocation
+// instead of three temporaries and four passes. Nodes refer to their
+// Matrix operands, so use them within the full expression; don't keep
+// one in an `auto` variable past the lifetime of its operands.
+// Matrix products and transpose() are not lazy: an expression operand
+// is evaluated into a Matrix first (eval()), then used as usual:
+//     Matrix<float> p = (a + b) * c;     // eval, then gemm
+// Every operand of a node has the same shape and a stride equal to its
+// column count, so nodes index their operands by flat offset k.
+
+namespace dsa{
+
+template <typename T>
+class Matrix;
+
+template <typename E>
+struct MatrixExpr {
+    const E& self() const {
+        return static_cast<const E&>(*this);
+    }
+
+    // the expression evaluated into a new Matrix, one fused pass
+    auto eval() const {
+        return Matrix<typename E::value_type>(self());
+    }
+
+    // eval().transpose()
+    auto transpose() const {
+        return eval().transpose();
+    }
+};
+
+// leaf: a Matrix operand
+template <typename T>
+class MatrixRef : public MatrixExpr<MatrixRef<T>> {
+private:
+    const T* elems;
+    int nrows;
+    int ncols;
+    std::pmr::memory_resource* mr;
+
+public:
+    using value_type = T;
+
+    explicit MatrixRef(const Matrix<T>& m); // in matrix.hpp
+
+    int rows() const { return nrows; }
+    int cols() const { return ncols; }
+    std::pmr::memory_resource* resource() const { return mr; }
+
+    T operator[](std::size_t k) const {
+        return elems[k];
+    }
+};
+
+struct MatrixAdd {
+    template <typename T>
+    T operator()(T x, T y) const { return static_cast<T>(x + y); }
+};
+
+struct MatrixSub {
+    template <typename T>
+    T operator()(T x, T y) const { return static_cast<T>(x - y); }
+};
+
+// throw std::out_of_range("Dimensions must match")
+// [k] = op(lhs[k], rhs[k])
+template <typename Op, typename L, typename R>
+class MatrixBinaryExpr : public MatrixExpr<MatrixBinaryExpr<Op, L, R>> {
+    static_assert(std::is_same_v<typename L::value_type, typename R::value_type>,
+                  "Matrix operands must have the same element type");
+
+private:
+    L lhs;
+    R rhs;
+
+public:
+    using value_type = typename L::value_type;
+
+    MatrixBinaryExpr(const L& l, const R& r) : lhs(l), rhs(r) {
+        if (l.rows() != r.rows() || l.cols() != r.cols()) {
+            throw std::out_of_range("Dimensions must match");
+        }
+    }
+
+    int rows() const { return lhs.rows(); }
+    int cols() const { return lhs.cols(); }
+    // results are allocated where the leftmost operand lives
+    std::pmr::memory_resource* resource() const { return lhs.resource(); }
+
+    value_type operator[](std::size_t k) const {
+        return Op{}(lhs[k], rhs[k]);
+    }
+};
+
+// [k] = expr[k] * s
+template <typename E>
+class MatrixScaledExpr : public MatrixExpr<MatrixScaledExpr<E>> {
+public:
+    using value_type = typename E::value_type;
+
+private:
+    E expr;
+    value_type s;
+
+public:
+    MatrixScaledExpr(const E& e, value_type scale) : expr(e), s(scale) {}
+
+    int rows() const { return expr.rows(); }
+    int cols() const { return expr.cols(); }
+    std::pmr::memory_resource* resource() const { return expr.resource(); }
+
+    value_type operator[](std::size_t k) const {
+        return static_cast<value_type>(expr[k] * s);
+    }
+};
+
+namespace detail{
+
+template <typename T>
+MatrixRef<T> as_expr(const Matrix<T>& m) {
+    return MatrixRef<T>(m);
+}
+
+template <typename E>
+const E& as_expr(const MatrixExpr<E>& e) {
+    return e.self();
+}
+
+template <typename X>
+using expr_t = std::remove_cvref_t<decltype(as_expr(std::declval<const X&>()))>;
+
+}//end namespace detail
+
+// a Matrix or an expression node
+template <typename X>
+concept MatrixOperand = requires(const X& x) { detail::as_expr(x); };
+
+template <MatrixOperand L, MatrixOperand R>
+auto operator+(const L& l, const R& r) {
+    return MatrixBinaryExpr<MatrixAdd, detail::expr_t<L>, detail::expr_t<R>>(
+        detail::as_expr(l), detail::as_expr(r));
+}
+
+template <MatrixOperand L, MatrixOperand R>
+auto operator-(const L& l, const R& r) {
+    return MatrixBinaryExpr<MatrixSub, detail::expr_t<L>, detail::expr_t<R>>(
+        detail::as_expr(l), detail::as_expr(r));
+}
+
+template <MatrixOperand M>
+auto operator*(const M& m, typename detail::expr_t<M>::value_type s) {
+    return MatrixScaledExpr<detail::expr_t<M>>(detail::as_expr(m), s);
+}
+
+template <MatrixOperand M>
+auto operator*(typename detail::expr_t<M>::value_type s, const M& m) {
+    return MatrixScaledExpr<detail::expr_t<M>>(detail::as_expr(m), s);
+}
+
+}//end namespace dsa
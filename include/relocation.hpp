@@ -0,0 +1,178 @@
+#pragma once
+
+#include <cstddef>      // std::size_t, std::max_align_t
+#include <cstdlib>      // std::malloc, std::calloc, std::realloc, std::free
+#include <cstring>      // std::memcpy
+#include <memory_resource> // std::pmr::memory_resource, std::pmr::new_delete_resource
+#include <new>          // std::bad_alloc
+#include <type_traits>  // std::bool_constant, std::is_trivially_copyable_v
+
+#if defined(__linux__)
+#include <sys/mman.h>   // mmap, mremap, munmap
+#include <unistd.h>     // sysconf
+#endif
+
+// Buffers of at least this many bytes are mapped directly from the kernel
+// so growth can use mremap; smaller ones come from malloc/realloc.
+#ifndef DSA_MREMAP_THRESHOLD
+#define DSA_MREMAP_THRESHOLD (std::size_t(64) << 20)
+#endif
+
+namespace dsa{
+
+// Opt-in trait: a relocatable T can be moved to a new address by copying
+// its bytes and forgetting the original, without running its move
+// constructor or destructor. Trivially copyable types qualify already;
+// specialize this to true_type for other types with that property
+// (e.g. types that only own heap pointers, never pointers into themselves).
+template <typename T>
+struct is_relocatable : std::bool_constant<std::is_trivially_copyable_v<T>> {};
+
+template <typename T>
+inline constexpr bool is_relocatable_v = is_relocatable<T>::value;
+
+namespace detail{
+
+// Raw byte buffers that can be grown in place. Every buffer is released
+// with its byte size, which tells us whether it came from malloc or mmap.
+struct relocatable_buffer {
+    // alignment the buffers guarantee
+    static constexpr std::size_t alignment = alignof(std::max_align_t);
+
+    static bool mapped(std::size_t bytes) {
+#if defined(__linux__)
+        return bytes >= DSA_MREMAP_THRESHOLD;
+#else
+        (void)bytes;
+        return false;
+#endif
+    }
+
+#if defined(__linux__)
+    static std::size_t page_round(std::size_t bytes) {
+        static const std::size_t page = static_cast<std::size_t>(sysconf(_SC_PAGESIZE));
+        return (bytes + page - 1) / page * page;
+    }
+#endif
+
+    static void* allocate(std::size_t bytes) {
+        void* p{nullptr};
+#if defined(__linux__)
+        if (mapped(bytes)) {
+            p = mmap(nullptr, page_round(bytes), PROT_READ | PROT_WRITE,
+                     MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+            if (p == MAP_FAILED) {
+                throw std::bad_alloc();
+            }
+            return p;
+        }
+#endif
+        p = std::malloc(bytes);
+        if (p == nullptr) {
+            throw std::bad_alloc();
+        }
+        return p;
+    }
+
+    // allocate, with every byte zero: a fresh anonymous mapping is zero
+    // already and calloc skips the memset for memory it gets fresh from
+    // the kernel, so untouched pages of a large buffer cost nothing until
+    // they are first written (or read)
+    static void* allocate_zeroed(std::size_t bytes) {
+        if (mapped(bytes)) {
+            return allocate(bytes);
+        }
+        void* p = std::calloc(bytes, 1);
+        if (p == nullptr) {
+            throw std::bad_alloc();
+        }
+        return p;
+    }
+
+    static void deallocate(void* p, std::size_t bytes) {
+        if (p == nullptr) {
+            return;
+        }
+#if defined(__linux__)
+        if (mapped(bytes)) {
+            munmap(p, page_round(bytes));
+            return;
+        }
+#endif
+        std::free(p);
+    }
+
+    // Resize p from old_bytes to new_bytes keeping its first live_bytes.
+    // The kernel remaps pages (mremap) or the allocator extends the block
+    // (realloc) so the contents are usually not copied at all; only a
+    // switch between malloc and mmap backing copies the live bytes.
+    // Resizing to 0 bytes releases p and returns nullptr (realloc(p, 0)
+    // may free p and return null, which would look like a failure).
+    static void* resize(void* p, std::size_t old_bytes, std::size_t new_bytes,
+                        std::size_t live_bytes) {
+        if (new_bytes == 0) {
+            deallocate(p, old_bytes);
+            return nullptr;
+        }
+        if (p == nullptr) {
+            return allocate(new_bytes);
+        }
+        bool was_mapped = mapped(old_bytes);
+        bool now_mapped = mapped(new_bytes);
+        if (was_mapped == now_mapped) {
+#if defined(__linux__)
+            if (now_mapped) {
+                void* q = mremap(p, page_round(old_bytes), page_round(new_bytes), MREMAP_MAYMOVE);
+                if (q == MAP_FAILED) {
+                    throw std::bad_alloc();
+                }
+                return q;
+            }
+#endif
+            void* q = std::realloc(p, new_bytes);
+            if (q == nullptr) {
+                throw std::bad_alloc();
+            }
+            return q;
+        }
+        void* q = allocate(new_bytes);
+        std::memcpy(q, p, live_bytes);
+        deallocate(p, old_bytes);
+        return q;
+    }
+};
+
+// memory_resource handing out relocatable_buffer::allocate_zeroed()
+// blocks, so whatever it allocates reads as zero bytes until written and
+// large blocks are backed by the OS only as their pages are touched.
+// Alignments above relocatable_buffer::alignment go to
+// new_delete_resource() (and are not zeroed).
+class ZeroedResource : public std::pmr::memory_resource {
+    void* do_allocate(std::size_t bytes, std::size_t align) override {
+        if (align > relocatable_buffer::alignment) {
+            return std::pmr::new_delete_resource()->allocate(bytes, align);
+        }
+        return relocatable_buffer::allocate_zeroed(bytes == 0 ? 1 : bytes);
+    }
+
+    void do_deallocate(void* p, std::size_t bytes, std::size_t align) override {
+        if (align > relocatable_buffer::alignment) {
+            std::pmr::new_delete_resource()->deallocate(p, bytes, align);
+            return;
+        }
+        relocatable_buffer::deallocate(p, bytes == 0 ? 1 : bytes);
+    }
+
+    bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override {
+        return this == &other;
+    }
+};
+
+// the process-wide ZeroedResource, never destroyed (like new_delete_resource)
+inline std::pmr::memory_resource* zeroed_resource() {
+    static ZeroedResource* resource = new ZeroedResource;
+    return resource;
+}
+
+}//end namespace detail
+}//end namespace dsa
@@ -0,0 +1,139 @@
+#pragma once
+
+#include "vector.hpp"
+#include <cstddef>  // std::size_t
+#include <initializer_list> // std::initializer_list
+#include <memory>   // std::allocator, std::allocator_traits
+#include <type_traits> // std::is_nothrow_move_constructible_v
+
+namespace dsa{
+
+// dsa::Vector with room for N elements inside the object itself.
+// Up to N elements need no heap allocation at all; the first push past N
+// moves everything to the heap (growing from N by the Growth policy) and
+// the vector stays there. The rest of the API is dsa::Vector's.
+// Differences: capacity() is at least N, and shrink()/shrink_to_fit()
+// never go below N while the elements are still inline.
+// Built on a private Vector base: a SmallVector is not a Vector (whose
+// destructor is not virtual, and whose moves assume no inline buffer).
+template <typename T, std::size_t N, typename Growth = DoublingGrowth, typename SizeType = std::size_t,
+          typename Allocator = std::allocator<T>>
+class SmallVector : private Vector<T, Growth, SizeType, Allocator> {
+    static_assert(N > 0, "SmallVector needs at least one inline slot");
+
+private:
+    using Base = Vector<T, Growth, SizeType, Allocator>;
+    using alloc_traits = std::allocator_traits<Allocator>;
+
+    alignas(T) unsigned char buffer[N * sizeof(T)]; // raw inline storage
+
+    // start of the inline buffer (the base initializers below spell this
+    // out, since member functions may not be called before Base exists)
+    T* inline_elems() {
+        return reinterpret_cast<T*>(buffer);
+    }
+
+public:
+    using typename Base::value_type;
+    using typename Base::size_type;
+    using typename Base::allocator_type;
+    using typename Base::iterator;
+    using typename Base::const_iterator;
+
+    using Base::get_allocator;
+    using Base::capacity;
+    using Base::size;
+    using Base::max_size;
+    using Base::empty;
+    using Base::operator[];
+    using Base::at;
+    using Base::front;
+    using Base::back;
+    using Base::data;
+    using Base::begin;
+    using Base::end;
+    using Base::cbegin;
+    using Base::cend;
+    using Base::emplace_back;
+    using Base::push_back;
+    using Base::pop_back;
+    using Base::insert;
+    using Base::append;
+    using Base::assign;
+    using Base::erase;
+    using Base::erase_if;
+    using Base::remove_indices;
+    using Base::resize;
+    using Base::resize_uninitialized;
+    using Base::reserve;
+    using Base::reallocate;
+    using Base::shrink_policy;
+    using Base::set_shrink_policy;
+    using Base::shrink;
+    using Base::shrink_to_fit;
+    using Base::stats;
+
+    // empty, using the inline buffer - O(1), no allocation
+    SmallVector() : Base(reinterpret_cast<T*>(buffer), N) {}
+
+    // empty, heap storage (past N elements) from a
+    explicit SmallVector(const Allocator& a) : Base(reinterpret_cast<T*>(buffer), N, a) {}
+
+    // copies of the elements of init, inline when they fit
+    SmallVector(std::initializer_list<T> init, const Allocator& a = Allocator())
+        : Base(reinterpret_cast<T*>(buffer), N, a) {
+        this->append(init.begin(), init.end());
+    }
+
+    // copies stay inline when other's elements fit
+    SmallVector(const SmallVector& other)
+        : Base(reinterpret_cast<T*>(buffer), N,
+               alloc_traits::select_on_container_copy_construction(other.get_allocator())) {
+        Base::operator=(other);
+    }
+
+    // a heap buffer is stolen, inline elements are moved one by one into
+    // our inline buffer; the allocator comes along, so nothing is
+    // allocated and only an element's move constructor can throw
+    SmallVector(SmallVector&& other) noexcept(std::is_nothrow_move_constructible_v<T>)
+        : Base(reinterpret_cast<T*>(buffer), N, other.get_allocator()) {
+        this->move_from(other, inline_elems(), N);
+        other.use_inline_storage(other.inline_elems(), N);
+    }
+
+    SmallVector& operator=(const SmallVector& other){
+        Base::operator=(other);
+        return *this;
+    }
+
+    // same as the move constructor; with an allocator that does not
+    // propagate and compares unequal, a heap source is moved element by
+    // element into our own storage, which may allocate
+    SmallVector& operator=(SmallVector&& other) noexcept(
+        std::is_nothrow_move_constructible_v<T> &&
+        (alloc_traits::propagate_on_container_move_assignment::value ||
+         alloc_traits::is_always_equal::value)) {
+        if (this != &other) {
+            this->move_from(other, inline_elems(), N);
+            other.use_inline_storage(other.inline_elems(), N);
+        }
+        return *this;
+    }
+
+    SmallVector& operator=(std::initializer_list<T> init){
+        Base::operator=(init);
+        return *this;
+    }
+
+    // number of inline slots
+    static constexpr std::size_t inline_capacity() {
+        return N;
+    }
+
+    // true while the elements live in the inline buffer
+    bool is_small() const {
+        return static_cast<const void*>(this->data()) == static_cast<const void*>(buffer);
+    }
+};
+
+}//end namespace dsa
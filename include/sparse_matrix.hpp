@@ -0,0 +1,575 @@
+#pragma once
+
+#include "matrix.hpp"
+#include "thread_pool.hpp"
+#include "vector.hpp"
+#include <algorithm>  // std::lower_bound, std::sort, std::min, std::max
+#include <cstddef>    // std::size_t
+#include <stdexcept>  // std::out_of_range
+#include <type_traits> // std::is_arithmetic_v
+
+// Compressed sparse matrices: only the nonzeros are stored, so a
+// 100000 x 100000 matrix with a million entries takes about 12 MB
+// instead of the 40 GB a dense Matrix<float> would.
+// CSR keeps the entries row by row, CSC column by column. Calling the
+// stored direction "major" (rows for CSR, columns for CSC) and the other
+// one "minor", entry e of major m has
+//     offsets()[m] <= e < offsets()[m + 1]
+//     minor index indices()[e], value values()[e]
+// and within a major the minor indices are strictly ascending.
+// CSR is the layout for y = A * x and for row-wise products; CSC is its
+// transpose in memory, for column access. Operations between two sparse
+// matrices convert the right operand to the layout of the left one.
+
+namespace dsa{
+
+enum class SparseLayout : unsigned char { csr, csc };
+
+// one (row, col, value) entry, the input format of SparseMatrix
+template <typename T = int>
+struct Triplet {
+    int row;
+    int col;
+    T value;
+};
+
+template <typename T = int>
+class SparseMatrix {
+    static_assert(std::is_arithmetic_v<T>, "SparseMatrix elements must be arithmetic");
+
+private:
+    int nrows{0};
+    int ncols{0};
+    SparseLayout order{SparseLayout::csr};
+    dsa::Vector<std::size_t> starts; // majors() + 1 entries
+    dsa::Vector<int> minor;          // per entry, ascending within a major
+    dsa::Vector<T> vals;             // per entry
+
+    int majors() const {
+        return order == SparseLayout::csr ? nrows : ncols;
+    }
+
+    int minors() const {
+        return order == SparseLayout::csr ? ncols : nrows;
+    }
+
+    // v = n copies of value, one allocation
+    template <typename U>
+    static void fill(dsa::Vector<U>& v, std::size_t n, U value) {
+        v.reserve(n);
+        for (std::size_t k = 0; k < n; k++) {
+            v.push_back(value);
+        }
+    }
+
+    // empty matrix of the given shape, offsets all zero
+    SparseMatrix(int r, int c, SparseLayout layout, std::size_t capacity)
+        : nrows(r), ncols(c), order(layout) {
+        if (r < 0 || c < 0) {
+            throw std::out_of_range("Negative dimensions");
+        }
+        starts.reserve(static_cast<std::size_t>(majors()) + 1);
+        starts.push_back(0);
+        minor.reserve(capacity);
+        vals.reserve(capacity);
+    }
+
+    // ends the current major: its entries are those appended since the last call
+    void close_major() {
+        starts.push_back(minor.size());
+    }
+
+    // y[i] = row i of this * x, for CSR rows [r0, r1)
+    void spmv_rows(const T* x, T* y, std::size_t r0, std::size_t r1) const {
+        const std::size_t* off = starts.data();
+        const int* col = minor.data();
+        const T* v = vals.data();
+        for (std::size_t i = r0; i < r1; i++) {
+            T sum = T(0);
+            for (std::size_t e = off[i]; e < off[i + 1]; e++) {
+                sum += v[e] * x[col[e]];
+            }
+            y[i] = sum;
+        }
+    }
+
+    // Gustavson's product, major by major: for every entry (k, p) of
+    // major m of P, add p times major k of Q into a dense accumulator,
+    // then gather the touched minors in order. For CSR, P = A and Q = B
+    // give the rows of A * B; for CSC, P = B and Q = A give its columns.
+    static void multiply_majors(const SparseMatrix& P, const SparseMatrix& Q, SparseMatrix& out) {
+        std::size_t width = static_cast<std::size_t>(out.minors());
+        dsa::Vector<T> acc;
+        dsa::Vector<int> seen; // seen[j] == m + 1 once minor j is touched in major m
+        dsa::Vector<int> touched; // the first count of them, for this major
+        fill(acc, width, T(0));
+        fill(seen, width, 0);
+        fill(touched, width, 0);
+        int* list = touched.data();
+        for (int m = 0; m < P.majors(); m++) {
+            std::size_t count = 0;
+            for (std::size_t e = P.starts[m]; e < P.starts[m + 1]; e++) {
+                int k = P.minor[e];
+                T p = P.vals[e];
+                for (std::size_t f = Q.starts[k]; f < Q.starts[k + 1]; f++) {
+                    int j = Q.minor[f];
+                    if (seen[j] != m + 1) {
+                        seen[j] = m + 1;
+                        acc[j] = T(0);
+                        list[count++] = j;
+                    }
+                    acc[j] += p * Q.vals[f];
+                }
+            }
+            std::sort(list, list + count);
+            for (std::size_t t = 0; t < count; t++) {
+                out.minor.push_back(list[t]);
+                out.vals.push_back(acc[list[t]]);
+            }
+            out.close_major();
+        }
+    }
+
+public:
+    /*
+    if r < 0 OR c < 0
+        throw std::out_of_range("Negative dimensions");
+    r x c matrix with no entries
+    */
+    SparseMatrix(int r, int c, SparseLayout layout = SparseLayout::csr)
+        : SparseMatrix(r, c, layout, 0) {
+        for (int m = 0; m < majors(); m++) {
+            close_major();
+        }
+    }
+
+    /*
+    if r < 0 OR c < 0
+        throw std::out_of_range("Negative dimensions");
+    if some triplet lies outside r x c
+        throw std::out_of_range("Invalid Index");
+    entries in any order; duplicates of one (row, col) are summed
+    */
+    // two stable counting sorts, by minor then by major, leave the
+    // triplets ordered by (major, minor) in O(nnz + rows + cols), then
+    // one pass merges the duplicates
+    SparseMatrix(int r, int c, const dsa::Vector<Triplet<T>>& triplets,
+                 SparseLayout layout = SparseLayout::csr)
+        : SparseMatrix(r, c, layout, triplets.size()) {
+        bool csr = order == SparseLayout::csr;
+        for (const Triplet<T>& t : triplets) {
+            if (t.row < 0 || t.row >= nrows || t.col < 0 || t.col >= ncols) {
+                throw std::out_of_range("Invalid Index");
+            }
+        }
+        auto major_of = [csr](const Triplet<T>& t) { return csr ? t.row : t.col; };
+        auto minor_of = [csr](const Triplet<T>& t) { return csr ? t.col : t.row; };
+        std::size_t nnz = triplets.size();
+        std::size_t M = static_cast<std::size_t>(majors());
+        std::size_t N = static_cast<std::size_t>(minors());
+
+        dsa::Vector<std::size_t> next;
+        fill(next, N + 1, std::size_t(0));
+        for (const Triplet<T>& t : triplets) {
+            next[minor_of(t) + 1]++;
+        }
+        for (std::size_t j = 0; j < N; j++) {
+            next[j + 1] += next[j];
+        }
+        dsa::Vector<std::size_t> by_minor;
+        fill(by_minor, nnz, std::size_t(0));
+        for (std::size_t k = 0; k < nnz; k++) {
+            by_minor[next[minor_of(triplets[k])]++] = k;
+        }
+
+        dsa::Vector<std::size_t> bounds;
+        fill(bounds, M + 1, std::size_t(0));
+        for (const Triplet<T>& t : triplets) {
+            bounds[major_of(t) + 1]++;
+        }
+        for (std::size_t m = 0; m < M; m++) {
+            bounds[m + 1] += bounds[m];
+        }
+        dsa::Vector<std::size_t> sorted;
+        dsa::Vector<std::size_t> at_major = bounds; // insert position of each major
+        fill(sorted, nnz, std::size_t(0));
+        for (std::size_t k : by_minor) {
+            sorted[at_major[major_of(triplets[k])]++] = k;
+        }
+
+        for (std::size_t m = 0; m < M; m++) {
+            std::size_t first = minor.size();
+            for (std::size_t s = bounds[m]; s < bounds[m + 1]; s++) {
+                const Triplet<T>& t = triplets[sorted[s]];
+                if (minor.size() > first && minor.back() == minor_of(t)) {
+                    vals.back() += t.value;
+                } else {
+                    minor.push_back(minor_of(t));
+                    vals.push_back(t.value);
+                }
+            }
+            close_major();
+        }
+    }
+
+    // the nonzeros of m, in the given layout
+    static SparseMatrix from_dense(const Matrix<T>& m, SparseLayout layout = SparseLayout::csr) {
+        SparseMatrix result(m.rows(), m.cols(), layout, 0);
+        const T* a = m.data();
+        std::size_t ld = m.stride();
+        bool csr = layout == SparseLayout::csr;
+        for (int p = 0; p < result.majors(); p++) {
+            for (int q = 0; q < result.minors(); q++) {
+                std::size_t i = static_cast<std::size_t>(csr ? p : q);
+                std::size_t j = static_cast<std::size_t>(csr ? q : p);
+                if (a[i * ld + j] != T(0)) {
+                    result.minor.push_back(q);
+                    result.vals.push_back(a[i * ld + j]);
+                }
+            }
+            result.close_major();
+        }
+        return result;
+    }
+
+    int rows() const {
+        return nrows;
+    }
+
+    int cols() const {
+        return ncols;
+    }
+
+    SparseLayout layout() const {
+        return order;
+    }
+
+    // number of stored entries
+    std::size_t nonzeros() const {
+        return vals.size();
+    }
+
+    // raw compressed arrays, see the top of this file
+    const dsa::Vector<std::size_t>& offsets() const {
+        return starts;
+    }
+
+    const dsa::Vector<int>& indices() const {
+        return minor;
+    }
+
+    const dsa::Vector<T>& values() const {
+        return vals;
+    }
+
+    /*
+    if i < 0 OR i >= rows OR j < 0 OR j >= cols
+        throw std::out_of_range("Invalid Index");
+    return the entry at (i, j), 0 if none is stored
+    */
+    // binary search within the major
+    T at(int i, int j) const {
+        if (i < 0 || i >= nrows || j < 0 || j >= ncols) {
+            throw std::out_of_range("Invalid Index");
+        }
+        bool csr = order == SparseLayout::csr;
+        int m = csr ? i : j;
+        int n = csr ? j : i;
+        const int* first = minor.data() + starts[m];
+        const int* last = minor.data() + starts[m + 1];
+        const int* it = std::lower_bound(first, last, n);
+        if (it == last || *it != n) {
+            return T(0);
+        }
+        return vals[static_cast<std::size_t>(it - minor.data())];
+    }
+
+    Matrix<T> to_dense() const {
+        Matrix<T> result(nrows, ncols);
+        T* a = result.data();
+        std::size_t ld = result.stride();
+        bool csr = order == SparseLayout::csr;
+        for (int m = 0; m < majors(); m++) {
+            for (std::size_t e = starts[m]; e < starts[m + 1]; e++) {
+                std::size_t i = static_cast<std::size_t>(csr ? m : minor[e]);
+                std::size_t j = static_cast<std::size_t>(csr ? minor[e] : m);
+                a[i * ld + j] = vals[e];
+            }
+        }
+        return result;
+    }
+
+    // the same matrix in the given layout; switching is a counting sort
+    // of the entries by minor index, O(nnz + rows + cols)
+    SparseMatrix with_layout(SparseLayout layout) const {
+        if (layout == order) {
+            return *this;
+        }
+        std::size_t nnz = vals.size();
+        SparseMatrix result(nrows, ncols, layout, nnz);
+        std::size_t N = static_cast<std::size_t>(minors());
+        for (std::size_t j = 0; j < N; j++) {
+            result.starts.push_back(0);
+        }
+        for (int j : minor) {
+            result.starts[j + 1]++;
+        }
+        for (std::size_t j = 0; j < N; j++) {
+            result.starts[j + 1] += result.starts[j];
+        }
+        dsa::Vector<std::size_t> next;
+        fill(next, N, std::size_t(0));
+        for (std::size_t j = 0; j < N; j++) {
+            next[j] = result.starts[j];
+        }
+        fill(result.minor, nnz, 0);
+        fill(result.vals, nnz, T(0));
+        // majors in ascending order, so every new major's minors come out sorted
+        for (int m = 0; m < majors(); m++) {
+            for (std::size_t e = starts[m]; e < starts[m + 1]; e++) {
+                std::size_t pos = next[minor[e]]++;
+                result.minor[pos] = m;
+                result.vals[pos] = vals[e];
+            }
+        }
+        return result;
+    }
+
+    SparseMatrix to_csr() const {
+        return with_layout(SparseLayout::csr);
+    }
+
+    SparseMatrix to_csc() const {
+        return with_layout(SparseLayout::csc);
+    }
+
+    /*
+    y = this * x, x has cols() elements, y has rows()
+    x and y must not overlap
+    */
+    // CSR: one dot product per row, rows split over the shared pool in
+    // chunks of about equal nonzero count, so a few very dense rows don't
+    // leave one thread with most of the work. CSC scatters each column
+    // into y and runs serially.
+    void spmv(const T* x, T* y) const {
+        std::size_t r = static_cast<std::size_t>(nrows);
+        if (order == SparseLayout::csc) {
+            for (std::size_t i = 0; i < r; i++) {
+                y[i] = T(0);
+            }
+            for (int j = 0; j < ncols; j++) {
+                T xj = x[j];
+                for (std::size_t e = starts[j]; e < starts[j + 1]; e++) {
+                    y[minor[e]] += vals[e] * xj;
+                }
+            }
+            return;
+        }
+        // a row costs its entries plus one store
+        std::size_t work = vals.size() + r;
+        std::size_t chunks = std::min(r, std::max<std::size_t>(1, work / parallel::grain()));
+        if (chunks <= 1) {
+            spmv_rows(x, y, 0, r);
+            return;
+        }
+        // first row of chunk c: where the running work reaches c / chunks of the total
+        auto chunk_start = [&](std::size_t c) -> std::size_t {
+            if (c == chunks) {
+                return r;
+            }
+            std::size_t target = c * (work / chunks);
+            std::size_t lo = 0;
+            std::size_t hi = r;
+            while (lo < hi) {
+                std::size_t mid = lo + (hi - lo) / 2;
+                if (starts[mid] + mid < target) {
+                    lo = mid + 1;
+                } else {
+                    hi = mid;
+                }
+            }
+            return lo;
+        };
+        parallel::pool().parallel_for(chunks, 1, [&](std::size_t first, std::size_t last) {
+            for (std::size_t c = first; c < last; c++) {
+                spmv_rows(x, y, chunk_start(c), chunk_start(c + 1));
+            }
+        });
+    }
+
+    // throw std::out_of_range("Dimensions must match") unless x.size == cols
+    // y = this * x
+    dsa::Vector<T> operator*(const dsa::Vector<T>& x) const {
+        if (x.size() != static_cast<std::size_t>(ncols)) {
+            throw std::out_of_range("Dimensions must match");
+        }
+        dsa::Vector<T> y;
+        fill(y, static_cast<std::size_t>(nrows), T(0));
+        spmv(x.data(), y.data());
+        return y;
+    }
+
+    // throw std::out_of_range("Dimensions must match") unless the shapes agree
+    // merge of the two sorted entry lists, major by major; the result
+    // has this matrix's layout
+    SparseMatrix operator+(const SparseMatrix& other) const {
+        if (nrows != other.nrows || ncols != other.ncols) {
+            throw std::out_of_range("Dimensions must match");
+        }
+        if (other.order != order) {
+            return *this + other.with_layout(order);
+        }
+        SparseMatrix result(nrows, ncols, order, vals.size() + other.vals.size());
+        for (int m = 0; m < majors(); m++) {
+            std::size_t e = starts[m];
+            std::size_t f = other.starts[m];
+            std::size_t e_end = starts[m + 1];
+            std::size_t f_end = other.starts[m + 1];
+            while (e < e_end || f < f_end) {
+                if (f == f_end || (e < e_end && minor[e] < other.minor[f])) {
+                    result.minor.push_back(minor[e]);
+                    result.vals.push_back(vals[e++]);
+                } else if (e == e_end || other.minor[f] < minor[e]) {
+                    result.minor.push_back(other.minor[f]);
+                    result.vals.push_back(other.vals[f++]);
+                } else {
+                    result.minor.push_back(minor[e]);
+                    result.vals.push_back(vals[e++] + other.vals[f++]);
+                }
+            }
+            result.close_major();
+        }
+        return result;
+    }
+
+    // throw std::out_of_range("Dimensions must match") unless the shapes agree
+    // a dense copy of other with this matrix's entries added
+    Matrix<T> operator+(const Matrix<T>& other) const {
+        if (nrows != other.rows() || ncols != other.cols()) {
+            throw std::out_of_range("Dimensions must match");
+        }
+        Matrix<T> result = other;
+        T* a = result.data();
+        std::size_t ld = result.stride();
+        bool csr = order == SparseLayout::csr;
+        for (int m = 0; m < majors(); m++) {
+            for (std::size_t e = starts[m]; e < starts[m + 1]; e++) {
+                std::size_t i = static_cast<std::size_t>(csr ? m : minor[e]);
+                std::size_t j = static_cast<std::size_t>(csr ? minor[e] : m);
+                a[i * ld + j] += vals[e];
+            }
+        }
+        return result;
+    }
+
+    friend Matrix<T> operator+(const Matrix<T>& dense, const SparseMatrix& sparse) {
+        return sparse + dense;
+    }
+
+    // throw std::out_of_range("Dimensions must match") unless cols == other.rows
+    // result = this * other, sparse, in this matrix's layout
+    SparseMatrix operator*(const SparseMatrix& other) const {
+        if (ncols != other.nrows) {
+            throw std::out_of_range("Dimensions must match");
+        }
+        if (other.order != order) {
+            return *this * other.with_layout(order);
+        }
+        SparseMatrix result(nrows, other.ncols, order, vals.size() + other.vals.size());
+        if (order == SparseLayout::csr) {
+            multiply_majors(*this, other, result);
+        } else {
+            multiply_majors(other, *this, result);
+        }
+        return result;
+    }
+
+    // throw std::out_of_range("Dimensions must match") unless cols == other.rows
+    // result = this * other, dense (rows x other.cols)
+    // CSR: row i of the result is a sum of scaled rows of other, rows
+    // spread over the shared pool; CSC runs serially
+    Matrix<T> operator*(const Matrix<T>& other) const {
+        if (ncols != other.rows()) {
+            throw std::out_of_range("Dimensions must match");
+        }
+        Matrix<T> result(nrows, other.cols());
+        const T* b = other.data();
+        std::size_t ldb = other.stride();
+        T* c = result.data();
+        std::size_t ldc = result.stride();
+        std::size_t n = static_cast<std::size_t>(other.cols());
+        // c row i += s * b row k
+        auto axpy = [b, ldb, c, ldc, n](std::size_t i, std::size_t k, T s) {
+            T* ci = c + i * ldc;
+            const T* bk = b + k * ldb;
+            for (std::size_t j = 0; j < n; j++) {
+                ci[j] += s * bk[j];
+            }
+        };
+        if (order == SparseLayout::csr) {
+            std::size_t r = static_cast<std::size_t>(nrows);
+            std::size_t per_row = std::max<std::size_t>(1, (vals.size() / std::max<std::size_t>(1, r) + 1) * n);
+            std::size_t grain = std::max<std::size_t>(1, parallel::grain() / per_row);
+            parallel::pool().parallel_for(r, grain, [&](std::size_t first, std::size_t last) {
+                for (std::size_t i = first; i < last; i++) {
+                    for (std::size_t e = starts[i]; e < starts[i + 1]; e++) {
+                        axpy(i, static_cast<std::size_t>(minor[e]), vals[e]);
+                    }
+                }
+            });
+        } else {
+            for (int k = 0; k < ncols; k++) {
+                for (std::size_t e = starts[k]; e < starts[k + 1]; e++) {
+                    axpy(static_cast<std::size_t>(minor[e]), static_cast<std::size_t>(k), vals[e]);
+                }
+            }
+        }
+        return result;
+    }
+
+    // throw std::out_of_range("Dimensions must match") unless dense.cols == sparse.rows
+    // result = dense * sparse, dense (dense.rows x sparse.cols), rows of
+    // the result spread over the shared pool
+    friend Matrix<T> operator*(const Matrix<T>& dense, const SparseMatrix& sparse) {
+        if (dense.cols() != sparse.nrows) {
+            throw std::out_of_range("Dimensions must match");
+        }
+        Matrix<T> result(dense.rows(), sparse.ncols);
+        const T* a = dense.data();
+        std::size_t lda = dense.stride();
+        T* c = result.data();
+        std::size_t ldc = result.stride();
+        std::size_t r = static_cast<std::size_t>(dense.rows());
+        std::size_t per_row = std::max<std::size_t>(1, sparse.vals.size() + static_cast<std::size_t>(sparse.nrows));
+        std::size_t grain = std::max<std::size_t>(1, parallel::grain() / per_row);
+        bool csr = sparse.order == SparseLayout::csr;
+        parallel::pool().parallel_for(r, grain, [&](std::size_t first, std::size_t last) {
+            for (std::size_t i = first; i < last; i++) {
+                const T* ai = a + i * lda;
+                T* ci = c + i * ldc;
+                for (int m = 0; m < sparse.majors(); m++) {
+                    if (csr) {
+                        // c row i += a(i, m) * sparse row m
+                        T s = ai[m];
+                        if (s == T(0)) {
+                            continue;
+                        }
+                        for (std::size_t e = sparse.starts[m]; e < sparse.starts[m + 1]; e++) {
+                            ci[sparse.minor[e]] += s * sparse.vals[e];
+                        }
+                    } else {
+                        // c(i, m) = a row i . sparse column m
+                        T sum = T(0);
+                        for (std::size_t e = sparse.starts[m]; e < sparse.starts[m + 1]; e++) {
+                            sum += ai[sparse.minor[e]] * sparse.vals[e];
+                        }
+                        ci[m] = sum;
+                    }
+                }
+            }
+        });
+        return result;
+    }
+};
+
+}//end namespace dsa
@@ -0,0 +1,127 @@
+#pragma once
+
+#include <atomic>      // std::atomic
+#include <condition_variable> // std::condition_variable
+#include <cstddef>     // std::size_t
+#include <deque>       // std::deque
+#include <exception>   // std::exception_ptr
+#include <memory>      // std::unique_ptr
+#include <mutex>       // std::mutex
+#include <thread>      // std::thread
+#include <type_traits> // std::remove_reference_t
+#include <vector>      // std::vector
+
+namespace dsa{
+
+// Work-stealing pool for data-parallel loops.
+// parallel_for(n, grain, f) calls f(begin, end) on disjoint ranges that
+// cover [0, n), each at most grain long. A range is split in halves: one
+// half goes to the back of the running thread's own deque, the thread
+// keeps working on the other. Threads pop their own deque from the back
+// (the most recent, cache-warm pieces) and steal from the front of the
+// others' (the largest pieces left). The calling thread works too, so a
+// pool of size() threads starts size() - 1 workers; with one thread,
+// parallel_for is a plain call to f(0, n).
+// The first exception thrown by f is rethrown by parallel_for once every
+// range has finished (ranges not started yet are skipped).
+// parallel_for may be called from several threads, and from inside f.
+class ThreadPool {
+public:
+    // threads == 0 means std::thread::hardware_concurrency()
+    explicit ThreadPool(unsigned threads = 0);
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    // threads that run tasks, the caller of parallel_for included
+    unsigned size() const {
+        return static_cast<unsigned>(workers.size()) + 1;
+    }
+
+    template <typename F>
+    void parallel_for(std::size_t n, std::size_t grain, F&& f) {
+        if (n == 0) {
+            return;
+        }
+        if (grain == 0) {
+            grain = 1;
+        }
+        if (n <= grain || workers.empty()) {
+            f(std::size_t(0), n);
+            return;
+        }
+        using Body = std::remove_reference_t<F>;
+        RangeFn call = [](void* ctx, std::size_t begin, std::size_t end) {
+            (*static_cast<Body*>(ctx))(begin, end);
+        };
+        run(call, const_cast<void*>(static_cast<const void*>(&f)), n, grain);
+    }
+
+private:
+    using RangeFn = void (*)(void* ctx, std::size_t begin, std::size_t end);
+
+    // one parallel_for call; lives on the caller's stack
+    struct Job {
+        RangeFn fn;
+        void* ctx;
+        std::size_t grain;
+        std::atomic<std::size_t> remaining; // indices not yet processed
+        std::atomic<bool> failed{false};
+        std::exception_ptr error;           // set once, by whoever sets failed
+    };
+
+    struct Task {
+        Job* job;
+        std::size_t begin;
+        std::size_t end;
+    };
+
+    struct Queue {
+        std::mutex lock;
+        std::deque<Task> tasks;
+    };
+
+    std::vector<std::thread> workers;
+    // one deque per worker, plus a shared one for threads outside the pool
+    std::vector<std::unique_ptr<Queue>> queues;
+    std::atomic<std::size_t> queued{0};   // tasks sitting in all deques
+    std::atomic<unsigned> sleepers{0};
+    std::atomic<bool> stopping{false};
+    std::mutex sleep_lock;
+    std::condition_variable wake;
+
+    void run(RangeFn fn, void* ctx, std::size_t n, std::size_t grain);
+    void worker_loop(std::size_t index);
+    std::size_t own_queue() const;
+    void push(std::size_t queue, const Task& task);
+    bool try_get(std::size_t queue, Task& task);
+    void execute(Task task, std::size_t queue);
+};
+
+// The pool Matrix operations run on, and its tuning knobs.
+namespace parallel{
+
+// shared pool, created on first use with hardware_concurrency() threads
+ThreadPool& pool();
+
+// replace the shared pool by one with n threads (0 = hardware_concurrency());
+// must not run while an operation is using the pool
+void set_threads(unsigned n);
+
+unsigned threads();
+
+// smallest amount of work, in elements, worth handing to another thread;
+// smaller operations run on the calling thread alone
+void set_grain(std::size_t elements);
+
+std::size_t grain();
+
+// f(begin, end) over [0, n) on the shared pool, in pieces of at most grain()
+template <typename F>
+void for_range(std::size_t n, F&& f) {
+    pool().parallel_for(n, grain(), f);
+}
+
+}//end namespace parallel
+}//end namespace dsa
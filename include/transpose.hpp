@@ -0,0 +1,206 @@
+#pragma once
+
+#include <algorithm>   // std::min, std::max
+#include <cstddef>     // std::size_t
+#include <type_traits> // std::is_trivially_copyable_v
+#include <utility>     // std::swap
+
+// Blocked, cache-oblivious transposes on row-major buffers.
+// The recursion halves the longer side of the block until it is at most
+// leaf x leaf elements, so at every level of the memory hierarchy some
+// level of the recursion fits: the source rows and destination rows it
+// touches stay in cache and in the TLB instead of striding a whole
+// column per element. Inside a leaf, whole tile x tile squares go
+// through a Tiles kernel and only the ragged edges are copied one by one.
+// For 4-byte elements (float, int) the kernels are 8x8 AVX or 4x4 SSE
+// in-register transposes (src/transpose.cpp); other types use ScalarTiles.
+// All functions take a row range [r0, r1) so callers can split the work
+// into bands of rows across threads.
+
+namespace dsa{
+namespace detail{
+
+inline constexpr std::size_t transpose_leaf = 64;
+
+// portable tile kernel
+template <typename T, std::size_t N = 8>
+struct ScalarTiles {
+    static constexpr std::size_t tile = N;
+
+    // dst tile = transpose of src tile
+    void transpose(const T* src, std::size_t lds, T* dst, std::size_t ldd) const {
+        for (std::size_t i = 0; i < N; i++) {
+            for (std::size_t j = 0; j < N; j++) {
+                dst[j * ldd + i] = src[i * lds + j];
+            }
+        }
+    }
+
+    // p, q = transpose of q, transpose of p (mirror tiles of one matrix)
+    void swap(T* p, T* q, std::size_t ld) const {
+        for (std::size_t i = 0; i < N; i++) {
+            for (std::size_t j = 0; j < N; j++) {
+                std::swap(p[i * ld + j], q[j * ld + i]);
+            }
+        }
+    }
+
+    // the diagonal tile at p, transposed in place
+    void transpose_diagonal(T* p, std::size_t ld) const {
+        for (std::size_t i = 0; i < N; i++) {
+            for (std::size_t j = i + 1; j < N; j++) {
+                std::swap(p[i * ld + j], p[j * ld + i]);
+            }
+        }
+    }
+};
+
+// leaf: dst(j, i) = src(i, j) over rows [r0, r1) x cols [c0, c1)
+template <typename T, typename Tiles>
+void transpose_leaf_block(const T* src, std::size_t lds, T* dst, std::size_t ldd,
+                          std::size_t r0, std::size_t r1, std::size_t c0, std::size_t c1,
+                          const Tiles& tiles) {
+    constexpr std::size_t t = Tiles::tile;
+    std::size_t rt = r0 + (r1 - r0) / t * t;
+    std::size_t ct = c0 + (c1 - c0) / t * t;
+    for (std::size_t i = r0; i < rt; i += t) {
+        for (std::size_t j = c0; j < ct; j += t) {
+            tiles.transpose(src + i * lds + j, lds, dst + j * ldd + i, ldd);
+        }
+        for (std::size_t ii = i; ii < i + t; ii++) {
+            for (std::size_t j = ct; j < c1; j++) {
+                dst[j * ldd + ii] = src[ii * lds + j];
+            }
+        }
+    }
+    for (std::size_t i = rt; i < r1; i++) {
+        for (std::size_t j = c0; j < c1; j++) {
+            dst[j * ldd + i] = src[i * lds + j];
+        }
+    }
+}
+
+// halfway split of [lo, hi) on a multiple of the tile size
+template <std::size_t Tile>
+std::size_t transpose_split(std::size_t lo, std::size_t hi) {
+    return lo + ((hi - lo) / 2 + Tile - 1) / Tile * Tile;
+}
+
+// dst(j, i) = src(i, j) for rows [r0, r1) x cols [c0, c1), recursively
+template <typename T, typename Tiles>
+void transpose_recursive(const T* src, std::size_t lds, T* dst, std::size_t ldd,
+                         std::size_t r0, std::size_t r1, std::size_t c0, std::size_t c1,
+                         const Tiles& tiles) {
+    std::size_t h = r1 - r0;
+    std::size_t w = c1 - c0;
+    if (h <= transpose_leaf && w <= transpose_leaf) {
+        transpose_leaf_block(src, lds, dst, ldd, r0, r1, c0, c1, tiles);
+    } else if (h >= w) {
+        std::size_t mid = transpose_split<Tiles::tile>(r0, r1);
+        transpose_recursive(src, lds, dst, ldd, r0, mid, c0, c1, tiles);
+        transpose_recursive(src, lds, dst, ldd, mid, r1, c0, c1, tiles);
+    } else {
+        std::size_t mid = transpose_split<Tiles::tile>(c0, c1);
+        transpose_recursive(src, lds, dst, ldd, r0, r1, c0, mid, tiles);
+        transpose_recursive(src, lds, dst, ldd, r0, r1, mid, c1, tiles);
+    }
+}
+
+// in-place leaf: swap block rows [r0, r1) x cols [c0, c1), which lies
+// on or above the diagonal, with its mirror image
+template <typename T, typename Tiles>
+void transpose_swap_leaf(T* a, std::size_t ld,
+                         std::size_t r0, std::size_t r1, std::size_t c0, std::size_t c1,
+                         const Tiles& tiles) {
+    constexpr std::size_t t = Tiles::tile;
+    for (std::size_t i = r0; i < r1; i += t) {
+        for (std::size_t j = c0; j < c1; j += t) {
+            bool full = i + t <= r1 && j + t <= c1;
+            if (full && i == j) {
+                tiles.transpose_diagonal(a + i * ld + i, ld);
+            } else if (full && i + t <= j) {
+                tiles.swap(a + i * ld + j, a + j * ld + i, ld);
+            } else {
+                // ragged edge, or a tile straddling the diagonal
+                for (std::size_t ii = i; ii < std::min(i + t, r1); ii++) {
+                    for (std::size_t jj = std::max(j, ii + 1); jj < std::min(j + t, c1); jj++) {
+                        std::swap(a[ii * ld + jj], a[jj * ld + ii]);
+                    }
+                }
+            }
+        }
+    }
+}
+
+// swap block rows [r0, r1) x cols [c0, c1) (c0 >= r1) with its mirror
+template <typename T, typename Tiles>
+void transpose_swap_recursive(T* a, std::size_t ld,
+                              std::size_t r0, std::size_t r1, std::size_t c0, std::size_t c1,
+                              const Tiles& tiles) {
+    std::size_t h = r1 - r0;
+    std::size_t w = c1 - c0;
+    if (h <= transpose_leaf && w <= transpose_leaf) {
+        transpose_swap_leaf(a, ld, r0, r1, c0, c1, tiles);
+    } else if (h >= w) {
+        std::size_t mid = transpose_split<Tiles::tile>(r0, r1);
+        transpose_swap_recursive(a, ld, r0, mid, c0, c1, tiles);
+        transpose_swap_recursive(a, ld, mid, r1, c0, c1, tiles);
+    } else {
+        std::size_t mid = transpose_split<Tiles::tile>(c0, c1);
+        transpose_swap_recursive(a, ld, r0, r1, c0, mid, tiles);
+        transpose_swap_recursive(a, ld, r0, r1, mid, c1, tiles);
+    }
+}
+
+// transpose the diagonal block [lo, hi) x [lo, hi) in place
+template <typename T, typename Tiles>
+void transpose_diagonal_recursive(T* a, std::size_t ld, std::size_t lo, std::size_t hi,
+                                  const Tiles& tiles) {
+    if (hi - lo <= transpose_leaf) {
+        transpose_swap_leaf(a, ld, lo, hi, lo, hi, tiles);
+        return;
+    }
+    std::size_t mid = transpose_split<Tiles::tile>(lo, hi);
+    transpose_diagonal_recursive(a, ld, lo, mid, tiles);
+    transpose_diagonal_recursive(a, ld, mid, hi, tiles);
+    transpose_swap_recursive(a, ld, lo, mid, mid, hi, tiles);
+}
+
+// 4-byte elements, SIMD kernels picked at runtime (src/transpose.cpp)
+void transpose_rows_32(const void* src, std::size_t lds, void* dst, std::size_t ldd,
+                       std::size_t r0, std::size_t r1, std::size_t cols);
+void transpose_in_place_rows_32(void* a, std::size_t ld, std::size_t n,
+                                std::size_t r0, std::size_t r1);
+
+// dst (cols x rows, row stride ldd) gets rows [r0, r1) of src
+// (rows x cols, row stride lds) as its columns [r0, r1)
+template <typename T>
+void transpose_rows(const T* src, std::size_t lds, T* dst, std::size_t ldd,
+                    std::size_t r0, std::size_t r1, std::size_t cols) {
+    if constexpr (sizeof(T) == 4 && std::is_trivially_copyable_v<T>) {
+        transpose_rows_32(src, lds, dst, ldd, r0, r1, cols);
+    } else {
+        transpose_recursive(src, lds, dst, ldd, r0, r1, std::size_t(0), cols, ScalarTiles<T>{});
+    }
+}
+
+// In-place transpose of the n x n matrix a, the part owned by rows
+// [r0, r1): their diagonal block and everything right of it, swapped with
+// the mirror image below the diagonal. Disjoint row ranges touch
+// disjoint elements, so they may run concurrently.
+template <typename T>
+void transpose_in_place_rows(T* a, std::size_t ld, std::size_t n,
+                             std::size_t r0, std::size_t r1) {
+    if constexpr (sizeof(T) == 4 && std::is_trivially_copyable_v<T>) {
+        transpose_in_place_rows_32(a, ld, n, r0, r1);
+    } else {
+        ScalarTiles<T> tiles;
+        transpose_diagonal_recursive(a, ld, r0, r1, tiles);
+        if (r1 < n) {
+            transpose_swap_recursive(a, ld, r0, r1, r1, n, tiles);
+        }
+    }
+}
+
+}//end namespace detail
+}//end namespace dsa
@@ -1,32 +1,462 @@
 #pragma once
 
-#include <algorithm>  // std::max
-#include <utility>    // std::move
-#include <stdexcept>  // std::out_of_range
+#include <algorithm>  // std::max, std::move_backward, std::rotate, std::find_if
+#include <compare>    // operator<=>
+#include <cstddef>    // std::size_t, std::ptrdiff_t
+#include <iterator>   // std::contiguous_iterator_tag, std::input_iterator, std::distance
+#include <cstring>    // std::memcpy, std::memmove, std::memset
+#include <initializer_list> // std::initializer_list
+#include <limits>     // std::numeric_limits
+#include <memory>     // std::allocator, std::allocator_traits, std::destroy, std::to_address
+#include <memory_resource> // std::pmr::polymorphic_allocator
+#include <ranges>     // std::ranges::forward_range, std::ranges::subrange
+#include <type_traits> // std::is_trivially_copyable_v, std::is_arithmetic_v, std::is_lvalue_reference_v, std::remove_cvref_t, std::is_invocable_v, std::is_unsigned_v, std::is_const_v, std::is_same_v
+#include <utility>    // std::move, std::cmp_less, std::cmp_greater_equal
+#include <stdexcept>  // std::out_of_range, std::invalid_argument, std::length_error
+#include "growth.hpp"
+#include "relocation.hpp"
+#include "vector_stats.hpp"
 
 namespace dsa{
 
-template <typename T>
+// Growth picks the capacity used when the vector is full (see growth.hpp)
+// SizeType is the unsigned type of sizes and indices; a narrower one such
+// as std::uint32_t makes the Vector object smaller and caps its length
+// Allocator supplies the storage; with std::pmr::polymorphic_allocator
+// (see dsa::pmr::Vector) the elements can come from an arena
+template <typename T, typename Growth = DoublingGrowth, typename SizeType = std::size_t,
+          typename Allocator = std::allocator<T>>
 class Vector {
+    static_assert(std::is_unsigned_v<SizeType>, "Vector size type must be unsigned");
+    static_assert(std::is_same_v<typename Allocator::value_type, T>, "Allocator must allocate T");
+
+public:
+    using value_type = T;
+    using size_type = SizeType;
+    using allocator_type = Allocator;
 
 private:
-    int cap{0};       // capacity of the array
-    int sz{0};        // number of actual entries
-    T* data{nullptr}; // pointer to array of elements
+    using alloc_traits = std::allocator_traits<Allocator>;
+
+    size_type cap{0};  // capacity of the array
+    size_type sz{0};   // number of actual entries
+    T* elems{nullptr}; // pointer to raw storage; only [0, sz) holds live objects
+    [[no_unique_address]] Growth growth{}; // growth policy, empty for the built-in ones
+    ShrinkPolicy shrinking{};              // when capacity is given back
+    bool inline_storage{false};            // elems is a SmallVector's inline buffer
+    [[no_unique_address]] Allocator alloc{}; // where elems comes from
+    [[no_unique_address]] detail::VectorCounters<> counters{}; // empty unless DSA_VECTOR_STATS
+
+    // capacity to grow to when full, as chosen by the growth policy
+    // (policies may or may not take the element size); at least cap+1
+    // and at most max_size()
+    //throw std::length_error("Vector capacity overflow") when already full
+    size_type next_capacity() const {
+        if (cap >= max_size()) {
+            throw std::length_error("Vector capacity overflow");
+        }
+        std::size_t next{0};
+        if constexpr (std::is_invocable_v<const Growth&, std::size_t, std::size_t>) {
+            next = growth(static_cast<std::size_t>(cap), sizeof(T));
+        } else {
+            next = growth(static_cast<std::size_t>(cap));
+        }
+        return static_cast<size_type>(std::clamp<std::size_t>(next, cap + 1, max_size()));
+    }
+
+    // relocatable elements live in malloc/mmap buffers that can grow in
+    // place with realloc/mremap instead of allocate + move + free; that
+    // bypasses the allocator, so only the default std::allocator allows it
+    static constexpr bool relocatable =
+        is_relocatable_v<T> && alignof(T) <= detail::relocatable_buffer::alignment &&
+        std::is_same_v<Allocator, std::allocator<T>>;
+
+    // raw storage for n elements, nothing is constructed
+    T* allocate(size_type n) {
+        counters.allocated(n, sizeof(T));
+        if constexpr (relocatable) {
+            return static_cast<T*>(detail::relocatable_buffer::allocate(n * sizeof(T)));
+        } else {
+            return alloc_traits::allocate(alloc, n);
+        }
+    }
+
+    // release raw storage obtained from allocate(n)
+    void deallocate(T* p, size_type n) {
+        if constexpr (relocatable) {
+            detail::relocatable_buffer::deallocate(p, n * sizeof(T));
+        } else if (p != nullptr) {
+            alloc_traits::deallocate(alloc, p, n);
+        }
+    }
+
+    // construct one element in raw storage at p through the allocator
+    // (which passes itself on to allocator-aware elements, e.g. the rows
+    // of a pmr::Vector<pmr::Vector<int>>)
+    template <typename... Args>
+    void construct(T* p, Args&&... args) {
+        alloc_traits::construct(alloc, p, std::forward<Args>(args)...);
+    }
+
+    // relocatable only: change the capacity to new_cap (>= sz) letting
+    // realloc/mremap carry the elements over; an inline buffer cannot be
+    // resized, so its bytes are copied out to a fresh heap buffer
+    void resize_storage(size_type new_cap) {
+        if (cap > 0) {
+            counters.reallocated();
+            counters.moved(sz);
+        }
+        if (inline_storage) {
+            T* new_array = allocate(new_cap);
+            std::memcpy(static_cast<void*>(new_array), elems, sz * sizeof(T));
+            elems = new_array;
+            cap = new_cap;
+            inline_storage = false;
+            return;
+        }
+        if (new_cap > 0) {
+            counters.allocated(new_cap, sizeof(T));
+        }
+        elems = static_cast<T*>(detail::relocatable_buffer::resize(
+            elems, cap * sizeof(T), new_cap * sizeof(T), sz * sizeof(T)));
+        cap = new_cap;
+    }
+
+    // trivially copyable elements are moved as raw bytes; the choice is
+    // made at compile time so other types keep their move operations
+    static constexpr bool bitwise_copyable = std::is_trivially_copyable_v<T>;
+
+    // move-construct [first, last) into raw storage at dest
+    // if one throws, the ones already built are destroyed again
+    void move_construct(T* first, T* last, T* dest) {
+        counters.moved(static_cast<std::size_t>(last - first));
+        if constexpr (bitwise_copyable) {
+            if (first != last) {
+                std::memcpy(dest, first, (last - first) * sizeof(T));
+            }
+        } else {
+            T* out = dest;
+            try {
+                for (; first != last; ++first, ++out) {
+                    construct(out, std::move(*first));
+                }
+            } catch (...) {
+                std::destroy(dest, out);
+                throw;
+            }
+        }
+    }
+
+    // copy-construct [first, last) into raw storage at dest
+    // if one throws, the ones already built are destroyed again
+    void copy_construct(const T* first, const T* last, T* dest) {
+        counters.copied(static_cast<std::size_t>(last - first));
+        if constexpr (bitwise_copyable) {
+            if (first != last) {
+                std::memcpy(dest, first, (last - first) * sizeof(T));
+            }
+        } else {
+            T* out = dest;
+            try {
+                for (; first != last; ++first, ++out) {
+                    construct(out, *first);
+                }
+            } catch (...) {
+                std::destroy(dest, out);
+                throw;
+            }
+        }
+    }
+
+    // shrink after a removal, only when the policy is automatic
+    void auto_shrink() {
+        if (shrinking.mode == ShrinkPolicy::Mode::automatic) {
+            shrink();
+        }
+    }
+
+    // copy-construct n elements from first into raw storage at dest; a
+    // contiguous range of T goes through copy_construct (one memcpy for
+    // trivially copyable T)
+    // if one throws, the ones already built are destroyed again
+    template <std::forward_iterator It>
+    void construct_from(It first, size_type n, T* dest) {
+        if constexpr (std::contiguous_iterator<It> && std::is_same_v<std::iter_value_t<It>, T>) {
+            const T* src = std::to_address(first);
+            copy_construct(src, src + n, dest);
+        } else {
+            counters.copied(n);
+            T* out = dest;
+            try {
+                for (; out != dest + n; ++first, ++out) {
+                    construct(out, *first);
+                }
+            } catch (...) {
+                std::destroy(dest, out);
+                throw;
+            }
+        }
+    }
+
+    // n copies of value into raw storage at dest, same cleanup
+    void construct_copies(const T& value, size_type n, T* dest) {
+        counters.copied(n);
+        T* out = dest;
+        try {
+            for (; out != dest + n; ++out) {
+                construct(out, value);
+            }
+        } catch (...) {
+            std::destroy(dest, out);
+            throw;
+        }
+    }
+
+    // n value-initialized elements (T()) in raw storage at dest, same cleanup
+    void construct_values(size_type n, T* dest) {
+        T* out = dest;
+        try {
+            for (; out != dest + n; ++out) {
+                construct(out);
+            }
+        } catch (...) {
+            std::destroy(dest, out);
+            throw;
+        }
+    }
+
+    // types whose value-initialized state (0, 0.0, nullptr) is all-zero
+    // bytes on every platform we build for; memset or zeroed memory makes
+    // them without constructing
+    static constexpr bool zero_initializable =
+        std::is_arithmetic_v<T> || std::is_enum_v<T> || std::is_pointer_v<T>;
+
+    // append n (> 0) value-initialized elements, at most one reallocation
+    //   zero_initializable T: an empty relocatable vector takes a zeroed
+    //     buffer from calloc/mmap, whose fresh pages the OS only backs
+    //     when first touched; otherwise reserve and memset
+    //   other T: construct T() in place
+    void append_values(std::size_t n) {
+        if (n > std::size_t(max_size() - sz)) {
+            throw std::length_error("Vector capacity overflow");
+        }
+        if constexpr (zero_initializable) {
+            if constexpr (relocatable) {
+                if (sz == 0 && n > cap) {
+                    size_type new_cap = grown_capacity(n);
+                    T* zeroed = static_cast<T*>(
+                        detail::relocatable_buffer::allocate_zeroed(new_cap * sizeof(T)));
+                    counters.allocated(new_cap, sizeof(T));
+                    replace_storage(zeroed, new_cap);
+                    sz = static_cast<size_type>(n);
+                    return;
+                }
+            }
+            reserve(grown_capacity(sz + n));
+            std::memset(static_cast<void*>(elems + sz), 0, n * sizeof(T));
+            sz += static_cast<size_type>(n);
+        } else {
+            insert_gap(sz, n, [&](T* dest) { construct_values(static_cast<size_type>(n), dest); });
+        }
+    }
+
+    // emplace_back(args) copy-constructs: args is one lvalue T
+    template <typename... Args>
+    static constexpr bool copies_one =
+        sizeof...(Args) == 1 && (std::is_same_v<std::remove_cvref_t<Args>, T> && ...) &&
+        (std::is_lvalue_reference_v<Args> && ...);
+
+    // emplace_back(args) move-constructs: args is one rvalue T
+    template <typename... Args>
+    static constexpr bool moves_one =
+        sizeof...(Args) == 1 && (std::is_same_v<std::remove_cvref_t<Args>, T> && ...) &&
+        !(std::is_lvalue_reference_v<Args> && ...);
+
+    // capacity for a bulk insert that needs `needed` slots: at least what
+    // the growth policy would pick next, so appending many small blocks
+    // stays amortized O(1) per element
+    //throw std::length_error("Vector capacity overflow") past max_size()
+    size_type grown_capacity(std::size_t needed) const {
+        if (needed > max_size()) {
+            throw std::length_error("Vector capacity overflow");
+        }
+        if (needed <= cap) {
+            return cap;
+        }
+        return std::max(static_cast<size_type>(needed), next_capacity());
+    }
+
+    // open a gap of n slots at index i (<= sz) and let fill(dest)
+    // construct the n new elements there
+    //   the tail [i, sz) is shifted exactly once
+    //   at most one reallocation; then the new elements are built in the
+    //     new buffer first and the old ones moved around them
+    //   otherwise trivially copyable T: memmove the tail, fill the gap
+    //   otherwise build the new elements past the end and rotate them in
+    // if fill throws, the vector is left as it was
+    template <typename Fill>
+    void insert_gap(size_type i, std::size_t n, Fill fill) {
+        if (n == 0) {
+            return;
+        }
+        if (n > std::size_t(max_size() - sz)) {
+            throw std::length_error("Vector capacity overflow");
+        }
+        if (sz + n > cap) {
+            size_type new_cap = grown_capacity(sz + n);
+            T* new_array = allocate(new_cap);
+            try {
+                fill(new_array + i);
+                try {
+                    move_construct(elems, elems + i, new_array);
+                } catch (...) {
+                    std::destroy(new_array + i, new_array + i + n);
+                    throw;
+                }
+                try {
+                    move_construct(elems + i, elems + sz, new_array + i + n);
+                } catch (...) {
+                    std::destroy(new_array, new_array + i + n);
+                    throw;
+                }
+            } catch (...) {
+                deallocate(new_array, new_cap);
+                throw;
+            }
+            replace_storage(new_array, new_cap);
+        } else if constexpr (bitwise_copyable) {
+            std::memmove(elems + i + n, elems + i, (sz - i) * sizeof(T));
+            try {
+                fill(elems + i);
+            } catch (...) {
+                std::memmove(elems + i, elems + i + n, (sz - i) * sizeof(T));
+                throw;
+            }
+            counters.moved(sz - i);
+        } else {
+            fill(elems + sz);
+            std::rotate(elems + i, elems + sz, elems + sz + n);
+            counters.moved(sz - i);
+        }
+        sz += static_cast<size_type>(n);
+    }
+
+    // move [first, last) down to dest (dest <= first), as erase does
+    void shift_down(T* first, T* last, T* dest) {
+        if (first == dest) {
+            return;
+        }
+        counters.moved(static_cast<std::size_t>(last - first));
+        if constexpr (bitwise_copyable) {
+            std::memmove(dest, first, (last - first) * sizeof(T));
+        } else {
+            std::move(first, last, dest);
+        }
+    }
+
+    // destroy the elements from index n on and make n the size
+    void truncate(size_type n) {
+        std::destroy(elems + n, elems + sz);
+        sz = n;
+    }
+
+    // destroy every element, keep the storage
+    void destroy_elements() {
+        std::destroy(elems, elems + sz);
+        sz = 0;
+    }
+
+    // destroy the live elements and release the storage
+    // (an inline buffer belongs to the SmallVector around us)
+    void release() {
+        std::destroy(elems, elems + sz);
+        if (!inline_storage) {
+            deallocate(elems, cap);
+        }
+    }
+
+    // release the current storage and take over new_array instead
+    void replace_storage(T* new_array, size_type new_cap) {
+        if (cap > 0) {
+            counters.reallocated();
+        }
+        release();
+        elems = new_array;
+        cap = new_cap;
+        inline_storage = false;
+    }
+
+protected:
+    // SmallVector only: start out on the caller's inline buffer of n slots
+    Vector(T* inline_buf, size_type n, const Allocator& a = Allocator()) : alloc(a) {
+        use_inline_storage(inline_buf, n);
+    }
+
+    // SmallVector only: move assignment that first falls back to our
+    // inline buffer of n slots. other's heap buffer is taken over; its
+    // inline elements (at most n) are moved one by one into ours. Nothing
+    // is allocated unless the allocators differ and other is on the heap.
+    void move_from(Vector& other, T* inline_buf, size_type n) {
+        release();
+        sz = 0;
+        cap = 0;
+        elems = nullptr;
+        inline_storage = false;
+        use_inline_storage(inline_buf, n);
+        growth = std::move(other.growth);
+        shrinking = other.shrinking;
+        if constexpr (alloc_traits::propagate_on_container_move_assignment::value) {
+            alloc = std::move(other.alloc);
+        }
+        transfer(other);
+    }
+
+    // SmallVector only: fall back to the inline buffer once we hold no
+    // storage, e.g. after our heap buffer was moved into another vector
+    void use_inline_storage(T* inline_buf, size_type n) {
+        if (elems == nullptr) {
+            elems = inline_buf;
+            cap = n;
+            inline_storage = true;
+        }
+    }
 
 public:
     // empty - O(1)
     Vector() = default;
+
+    // empty, growing with the given policy object (e.g. a stateful callable)
+    explicit Vector(const Growth& g, const Allocator& a = Allocator()) : growth(g), alloc(a) {}
+
+    // empty, allocating from a (e.g. a polymorphic_allocator on an arena)
+    explicit Vector(const Allocator& a) : alloc(a) {}
+
+    // copies of the elements of init, in one allocation of exactly init.size()
+    Vector(std::initializer_list<T> init, const Allocator& a = Allocator()) : alloc(a) {
+        append(init.begin(), init.end());
+    }
+
+    // copy of the allocator in use
+    Allocator get_allocator() const {
+        return alloc;
+    }
     
     //capacity - O(1)
-    int capacity() const {
+    size_type capacity() const {
         return cap;
     }
 
     //elements stored
-    int size() const {
+    size_type size() const {
         return sz;
     }
+
+    // largest capacity the size type and the address space allow
+    static constexpr size_type max_size() {
+        constexpr std::size_t by_bytes = std::numeric_limits<std::size_t>::max() / sizeof(T);
+        constexpr std::size_t by_type = std::numeric_limits<size_type>::max();
+        return static_cast<size_type>(std::min(by_bytes, by_type));
+    }
     
     //return (sz == 0)
     //O(1)
@@ -38,428 +468,884 @@ public:
     }
     
     //element at index when vector is const (unchecked)
-    //return data[i] // no bounds check
+    //return elems[i] // no bounds check
     //O(1)
-    const T& operator[](int i) const { 
-        return data[i];
+    const T& operator[](size_type i) const { 
+        return elems[i];
     }
     
     //element at index when vector is non-const (unchecked)
-    //return data[i] // no bounds check
+    //return elems[i] // no bounds check
     //O(1)
-    T& operator[](int i) { 
-        return data[i];
+    T& operator[](size_type i) { 
+        return elems[i];
     }
     
     // at function for const (checked)
     //if invalid index 
     //throw std::out_of_range("Invalid Index");
-    //return data[i] after checking bounds
-    const T& at(int i) const{
-        if (i < 0 || i >= sz) {
+    //return elems[i] after checking bounds
+    const T& at(size_type i) const{
+        if (i >= sz) {
             throw std::out_of_range("Invalid Index");
         }
-        return data[i];
+        return elems[i];
     }
     
     // at function for non const (checked)
     //if invalid index 
     //throw std::out_of_range("Invalid Index");
-    //return data[i] after checking bounds
-    T& at(int i){
-        if (i < 0 || i >= sz) {
+    //return elems[i] after checking bounds
+    T& at(size_type i){
+        if (i >= sz) {
             throw std::out_of_range("Invalid Index");
         }
-        return data[i];
+        return elems[i];
     }
     
     // first element
     //throw std::out_of_range("front on empty Vector");
-    //return data[0]
+    //return elems[0]
     const T& front() const { 
         if (sz == 0) {
             throw std::out_of_range("front on empty Vector");
         }
-        return data[0];
+        return elems[0];
     }
 
     // first element
     //throw std::out_of_range("front on empty Vector");
-    //return data[0]
+    //return elems[0]
     T& front() {
         if (sz == 0) {
             throw std::out_of_range("front on empty Vector");
         }
-        return data[0];
+        return elems[0];
     }
     
     // last element
     //throw std::out_of_range("back on empty Vector");
-    //return data[sz-1]
+    //return elems[sz-1]
     const T& back() const { 
         if (sz == 0) {
             throw std::out_of_range("back on empty Vector");
         }
-        return data[sz - 1];
+        return elems[sz - 1];
     }
 
     // last element
     //throw std::out_of_range("back on empty Vector");
-    //return data[sz-1]
+    //return elems[sz-1]
     T& back() {
         if (sz == 0) {
             throw std::out_of_range("back on empty Vector");
         }
-        return data[sz - 1];
+        return elems[sz - 1];
     }
     
-    // insert at end
-    // double array size
-    //   if sz==cap: reserve(max(1, 2*cap))
-    //   data[sz] = elem
+    // construct a new last element in place from args
+    //   if sz==cap: allocate next_capacity() slots, build the new element
+    //     there first (args may refer into the old buffer), then move
+    //     the old elements over
+    //   relocatable T: build the element aside and grow the buffer in place
+    //   else construct elems[sz] directly
     //   sz++
     //Amortized O(1); worst-case O(n)
-    void push_back(const T& elem){
-        if (sz == cap) {
-            reserve(std::max(1, 2 * cap));
+    template <typename... Args>
+    T& emplace_back(Args&&... args){
+        if (sz == cap && relocatable) {
+            T tmp(std::forward<Args>(args)...);  // args may refer into the buffer
+            resize_storage(next_capacity());
+            construct(elems + sz, std::move(tmp));
+        } else if (sz == cap) {
+            size_type new_cap = next_capacity();
+            T* new_array = allocate(new_cap);
+            try {
+                construct(new_array + sz, std::forward<Args>(args)...);
+            } catch (...) {
+                deallocate(new_array, new_cap);
+                throw;
+            }
+            try {
+                move_construct(elems, elems + sz, new_array);
+            } catch (...) {
+                std::destroy_at(new_array + sz);
+                deallocate(new_array, new_cap);
+                throw;
+            }
+            replace_storage(new_array, new_cap);
+        } else {
+            construct(elems + sz, std::forward<Args>(args)...);
         }
-        data[sz] = elem;
-        sz++;
+        if constexpr (copies_one<Args...>) {
+            counters.copied(1);
+        } else if constexpr (moves_one<Args...>) {
+            counters.moved(1);
+        }
+        return elems[sz++];
+    }
+
+    // insert at end, copying elem
+    //Amortized O(1); worst-case O(n)
+    void push_back(const T& elem){
+        emplace_back(elem);
+    }
+
+    // insert at end, moving from elem
+    //Amortized O(1); worst-case O(n)
+    void push_back(T&& elem){
+        emplace_back(std::move(elem));
     }
 
     // remove from end
     //   if sz==0 -> throw
     //   sz--
-    //   shrink()
+    //   shrink() if the shrink policy is automatic
     // O(1) (shrink can be O(n) when it triggers)
     void pop_back() { 
         if (sz == 0) {
             throw std::out_of_range("remove on empty Vector");
         }
         sz--;
-        shrink();
+        std::destroy_at(elems + sz);
+        auto_shrink();
     }
 
     // insert at index
-    //   if i<0 or i>sz -> throw
-    //   if sz==cap: reserve(max(1, 2*cap))
-    //   shift right
-    //   data[i] = elem
+    //   if i>sz -> throw
+    //   if sz==cap: reserve(next_capacity())
+    //   shift right (the slot past the end is raw, so construct it)
+    //   elems[i] = elem
     //   sz++
     // Complexity: O(n-i) moves + possible O(n) reallocation
-    void insert(int i, const T& elem){
-        if (i < 0 || i > sz) {
+    void insert(size_type i, const T& elem){
+        if (i > sz) {
             throw std::out_of_range("Invalid index");
         }
+        T tmp(elem);  // elem may alias an element we are about to shift
+        counters.copied(1);
         if (sz == cap) {
-            reserve(std::max(1, 2 * cap));
+            reserve(next_capacity());
         }
-        for (int k = sz - 1; k >= i; k--) {
-            data[k + 1] = data[k];
+        if constexpr (bitwise_copyable) {
+            std::memmove(elems + i + 1, elems + i, (sz - i) * sizeof(T));
+            construct(elems + i, std::move(tmp));
+        } else if (i == sz) {
+            construct(elems + sz, std::move(tmp));
+        } else {
+            construct(elems + sz, std::move(elems[sz - 1]));
+            std::move_backward(elems + i, elems + sz - 1, elems + sz);
+            elems[i] = std::move(tmp);
         }
-        data[i] = elem;
+        counters.moved(sz - i);
         sz++;
     }
 
     // removes at index
-    //   if i<0 or i>=sz -> throw
+    //   if i>=sz -> throw
     //  shift left
-    //   sz--
-    //   shrink()
+    //   sz--; destroy the vacated last slot
+    //   shrink() if the shrink policy is automatic
     // Complexity: O(n-i) moves; shrink may reallocate O(n)
-    void erase(int i){
-        if (i < 0 || i >= sz) {
+    void erase(size_type i){
+        if (i >= sz) {
             throw std::out_of_range("Invalid index");
         }
-        for (int k = i + 1; k < sz; k++) {
-            data[k - 1] = data[k];
+        counters.moved(sz - i - 1);
+        if constexpr (bitwise_copyable) {
+            std::memmove(elems + i, elems + i + 1, (sz - i - 1) * sizeof(T));
+            sz--;
+        } else {
+            std::move(elems + i + 1, elems + sz, elems + i);
+            sz--;
+            std::destroy_at(elems + sz);
+        }
+        auto_shrink();
+    }
+
+    // insert copies of [first, last) before index i
+    //   if i>sz -> throw std::out_of_range("Invalid index")
+    //   forward iterators: one capacity check, at most one reallocation,
+    //     the tail [i, sz) shifted once
+    //   input iterators: read into a temporary first (or push_back at the end)
+    //   first, last must not point into this vector
+    // Complexity: O(n-i + count) + possible O(n) reallocation
+    template <std::input_iterator It>
+    void insert(size_type i, It first, It last){
+        if (i > sz) {
+            throw std::out_of_range("Invalid index");
+        }
+        if constexpr (std::forward_iterator<It>) {
+            std::size_t n = static_cast<std::size_t>(std::distance(first, last));
+            insert_gap(i, n, [&](T* dest) { construct_from(first, static_cast<size_type>(n), dest); });
+        } else if (i == sz) {
+            for (; first != last; ++first) {
+                emplace_back(*first);
+            }
+        } else {
+            Vector tmp(alloc);
+            tmp.insert(0, first, last);
+            insert_gap(i, tmp.sz, [&](T* dest) { move_construct(tmp.elems, tmp.elems + tmp.sz, dest); });
         }
-        sz--;
-        shrink();
+    }
+
+    // insert count copies of value before index i
+    //   if i>sz -> throw std::out_of_range("Invalid index")
+    //   one capacity check, at most one reallocation, tail shifted once
+    //   value may be an element of this vector
+    // Complexity: O(n-i + count) + possible O(n) reallocation
+    void insert(size_type i, size_type count, const T& value){
+        if (i > sz) {
+            throw std::out_of_range("Invalid index");
+        }
+        T tmp(value);  // value may alias an element we are about to shift
+        insert_gap(i, count, [&](T* dest) { construct_copies(tmp, count, dest); });
+    }
+
+    // append copies of [first, last) at the end: insert(size(), first, last)
+    // first, last must not point into this vector
+    // Complexity: O(count) + possible O(n) reallocation
+    template <std::input_iterator It>
+    void append(It first, It last){
+        insert(sz, first, last);
+    }
+
+    // replace the contents with copies of [first, last)
+    //   forward iterators: at most one allocation, of exactly the range's length
+    //   first, last must not point into this vector
+    //throw std::length_error("Vector capacity overflow") past max_size(),
+    //   with the contents unchanged (forward iterators)
+    // Complexity: O(n + count)
+    template <std::input_iterator It>
+    void assign(It first, It last){
+        if constexpr (std::forward_iterator<It>) {
+            std::size_t n = static_cast<std::size_t>(std::distance(first, last));
+            if (n > max_size()) {
+                throw std::length_error("Vector capacity overflow");
+            }
+            destroy_elements();
+            reserve(static_cast<size_type>(n));
+            construct_from(first, static_cast<size_type>(n), elems);
+            sz = static_cast<size_type>(n);
+        } else {
+            destroy_elements();
+            for (; first != last; ++first) {
+                emplace_back(*first);
+            }
+        }
+    }
+
+    // replace the contents with count copies of value
+    // value may be an element of this vector
+    // Complexity: O(n + count)
+    void assign(size_type count, const T& value){
+        T tmp(value);
+        destroy_elements();
+        reserve(count);
+        construct_copies(tmp, count, elems);
+        sz = count;
+    }
+
+    // replace the contents with copies of the elements of init
+    void assign(std::initializer_list<T> init){
+        assign(init.begin(), init.end());
+    }
+
+    Vector& operator=(std::initializer_list<T> init){
+        assign(init);
+        return *this;
+    }
+
+    // make the size n
+    //   n < sz: destroy the elements from n on, shrink() once if automatic
+    //   n > sz: append n-sz value-initialized elements (T(), so 0 for
+    //     numbers), at most one reallocation; numbers, enums and pointers
+    //     are zeroed with memset, and an empty Vector of them with the
+    //     default allocator gets calloc/mmap memory the OS zeroes lazily
+    //throw std::length_error("Vector capacity overflow") past max_size()
+    // Complexity: O(|n - sz|) + possible O(n) reallocation
+    void resize(size_type n){
+        if (n < sz) {
+            truncate(n);
+            auto_shrink();
+        } else if (n > sz) {
+            append_values(n - sz);
+        }
+    }
+
+    // same, the new elements are copies of value (which may be an element)
+    void resize(size_type n, const T& value){
+        if (n < sz) {
+            truncate(n);
+            auto_shrink();
+        } else if (n > sz) {
+            insert(sz, n - sz, value);
+        }
+    }
+
+    // resize(n) for trivial T, but the new elements are default-initialized:
+    // left unwritten, holding whatever the memory held. For a buffer that
+    // is about to be overwritten whole (read() into data(), a kernel's
+    // output) this skips the zeroing pass; reading an element before it is
+    // written is undefined
+    //throw std::length_error("Vector capacity overflow") past max_size()
+    // Complexity: O(1) + possible O(n) reallocation
+    void resize_uninitialized(size_type n)
+        requires (std::is_trivially_default_constructible_v<T> && std::is_trivially_destructible_v<T>)
+    {
+        if (n < sz) {
+            sz = n;
+            auto_shrink();
+        } else if (n > sz) {
+            reserve(grown_capacity(n));
+            sz = n;
+        }
+    }
+
+    // removes the elements at indices [first, last)
+    //   if first>last or last>sz -> throw std::out_of_range("Invalid index")
+    //   shift the tail left once, destroy the vacated slots
+    //   shrink() once if the shrink policy is automatic
+    // Complexity: O(n-first); shrink may reallocate O(n)
+    void erase(size_type first, size_type last){
+        if (first > last || last > sz) {
+            throw std::out_of_range("Invalid index");
+        }
+        if (first == last) {
+            return;
+        }
+        shift_down(elems + last, elems + sz, elems + first);
+        truncate(sz - (last - first));
+        auto_shrink();
+    }
+
+    // removes every element for which pred(element) is true
+    //   one stable compaction pass: the kept elements move down over the
+    //   removed ones, each at most once, in their original order
+    //   shrink() once at the end if the shrink policy is automatic
+    //   return the number removed
+    // Complexity: O(n) calls of pred and moves; shrink may reallocate O(n)
+    template <typename Pred>
+    size_type erase_if(Pred pred){
+        T* first_removed = std::find_if(elems, elems + sz, pred);
+        if (first_removed == elems + sz) {
+            return 0;
+        }
+        T* kept_end = first_removed;
+        for (T* p = first_removed + 1; p != elems + sz; ++p) {
+            if (!pred(*p)) {
+                *kept_end++ = std::move(*p);
+            }
+        }
+        counters.moved(static_cast<std::size_t>(kept_end - first_removed));
+        size_type removed = static_cast<size_type>(elems + sz - kept_end);
+        truncate(sz - removed);
+        auto_shrink();
+        return removed;
+    }
+
+    // removes the elements at the given indices, which must be ascending
+    // (repeats are removed once)
+    //   if an index>=sz -> throw std::out_of_range("Invalid index")
+    //   if the indices are not ascending
+    //     throw std::invalid_argument("Indices must be sorted")
+    //   (both checked before anything is removed)
+    //   one compaction pass: each block between two removed indices is
+    //   moved down once; shrink() once at the end if automatic
+    //   return the number removed
+    // Complexity: O(n - first index + count); shrink may reallocate O(n)
+    template <std::ranges::forward_range R>
+    size_type remove_indices(const R& indices){
+        bool any = false;
+        size_type prev = 0;
+        for (auto index : indices) {
+            if (std::cmp_less(index, 0) || std::cmp_greater_equal(index, sz)) {
+                throw std::out_of_range("Invalid index");
+            }
+            size_type i = static_cast<size_type>(index);
+            if (any && i < prev) {
+                throw std::invalid_argument("Indices must be sorted");
+            }
+            any = true;
+            prev = i;
+        }
+        if (!any) {
+            return 0;
+        }
+        T* out = nullptr; // where the next kept element goes
+        T* next = nullptr; // first element not yet kept or removed
+        for (auto index : indices) {
+            T* hole = elems + static_cast<size_type>(index);
+            if (out == nullptr) {
+                out = hole;
+            } else if (hole >= next) {
+                shift_down(next, hole, out);
+                out += hole - next;
+            } else {
+                continue; // a repeat
+            }
+            next = hole + 1;
+        }
+        shift_down(next, elems + sz, out);
+        out += elems + sz - next;
+        size_type removed = static_cast<size_type>(elems + sz - out);
+        truncate(sz - removed);
+        auto_shrink();
+        return removed;
+    }
+
+    size_type remove_indices(std::initializer_list<size_type> indices){
+        return remove_indices(std::ranges::subrange(indices.begin(), indices.end()));
     }
 
     //capacity >= minimum
     //if cap < minimum:
-    // create new array and move elements
-    // O(n) when reallocation else O(1)
-    void reserve(int minimum){
-        if (cap < minimum) {
-            T* new_array = new T[minimum];
-            for (int k = 0; k < sz; k++) {
-                new_array[k] = std::move(data[k]);
+    // allocate raw storage and move-construct the elements into it
+    // (the new slots past sz stay unconstructed)
+    // O(n) when reallocation else O(1); relocatable T may grow in place
+    //throw std::length_error("Vector capacity overflow") past max_size()
+    void reserve(size_type minimum){
+        if (minimum > max_size()) {
+            throw std::length_error("Vector capacity overflow");
+        }
+        if (cap < minimum && relocatable) {
+            resize_storage(minimum);
+        } else if (cap < minimum) {
+            T* new_array = allocate(minimum);
+            try {
+                move_construct(elems, elems + sz, new_array);
+            } catch (...) {
+                deallocate(new_array, minimum);
+                throw;
             }
-            delete[] data;
-            data = new_array;
-            cap = minimum;
+            replace_storage(new_array, minimum);
         }
     }
 
-    // nested iterator class
-    class iterator {
+    // nested iterator template: a plain pointer into the buffer, so it is
+    // a std::contiguous_iterator and algorithms can see through it to the
+    // raw memory (memmove, vectorized loops). U is T or const T.
+    template <typename U>
+    class basic_iterator {
         // needed by Vector's insert and erase
         friend class Vector;
-        
+
         private:
-            Vector* vec;
-            int ind;   // index within the vector
+            U* ptr{nullptr};   // element this iterator refers to
+
         public:
-            // constructor
-            iterator(Vector* v=nullptr, int i=-1){ 
-                vec=v; ind=i; 
+            using iterator_concept = std::contiguous_iterator_tag;
+            using iterator_category = std::random_access_iterator_tag;
+            using value_type = std::remove_const_t<U>;
+            using element_type = U;
+            using difference_type = std::ptrdiff_t;
+            using pointer = U*;
+            using reference = U&;
+
+            basic_iterator() = default;
+
+            explicit basic_iterator(U* p){
+                ptr = p;
+            }
+
+            // iterator converts to const_iterator, not the other way round
+            template <typename V>
+                requires (std::is_const_v<U> && std::is_same_v<const V, U>)
+            basic_iterator(basic_iterator<V> other){
+                ptr = other.operator->();
+            }
+
+            //return *ptr
+            U& operator*() const {
+                return *ptr;
             }
 
-            //return this->vec->[this->ind];
-            T& operator*() const {
-                return vec->data[ind];
+            //return ptr
+            U* operator->() const {
+                return ptr;
             }
 
-            // return address of this->vec->[this->ind];
-            T* operator->() const { 
-                return &(vec->data[ind]);
+            //return ptr[n]
+            U& operator[](difference_type n) const {
+                return ptr[n];
             }
 
             //pre increment overloaded without param
-            //ind++; return *this
-            iterator& operator++(){
-                ind++;
+            //ptr++; return *this
+            basic_iterator& operator++(){
+                ptr++;
                 return *this;
             }
 
             //post increment overloaded with parameter
-            //old=*this; ind++; return old
-            iterator operator++(int){ 
-                iterator old = *this;
-                ind++;
+            //old=*this; ptr++; return old
+            basic_iterator operator++(int){
+                basic_iterator old = *this;
+                ptr++;
                 return old;
             }
 
-            //pre decrementr overloaded without param
-            //ind--; return *this
-            iterator& operator--(){
-                ind--;
+            //pre decrement overloaded without param
+            //ptr--; return *this
+            basic_iterator& operator--(){
+                ptr--;
                 return *this;
             }
-            
+
             //post decrement overloaded with parameter
-            //old=*this; ind--; return old
-            iterator operator--(int){
-                iterator old = *this;
-                ind--;
+            //old=*this; ptr--; return old
+            basic_iterator operator--(int){
+                basic_iterator old = *this;
+                ptr--;
                 return old;
             }
 
-            //return vec==rhs.vec && ind==rhs.ind
-            bool operator==(iterator rhs) const{
-                return (vec == rhs.vec) && (ind == rhs.ind);
+            //ptr += n; return *this
+            basic_iterator& operator+=(difference_type n){
+                ptr += n;
+                return *this;
             }
 
-            //return !(*this == rhs)
-            bool operator!=(iterator rhs) const{
-                return !(*this == rhs);
+            //ptr -= n; return *this
+            basic_iterator& operator-=(difference_type n){
+                ptr -= n;
+                return *this;
             }
-    };
 
-    // nested const_iterator class
-    class const_iterator {
-        private:
-            const Vector* vec;
-            int ind;   // index within the vector
-        
-        public:
-            const_iterator(const Vector* v=nullptr, int i=-1){
-                vec = v; ind=i;
+            friend basic_iterator operator+(basic_iterator it, difference_type n){
+                return it += n;
             }
 
-            //return vec->data[ind]
-            const T& operator*() const { 
-                return vec->data[ind];
-            }
-            
-            //return &vec->data[ind]
-            const T* operator->() const { 
-                return &(vec->data[ind]);
+            friend basic_iterator operator+(difference_type n, basic_iterator it){
+                return it += n;
             }
 
-            //pre
-            //ind++; return *this
-            const_iterator& operator++(){
-                ind++;
-                return *this;
+            friend basic_iterator operator-(basic_iterator it, difference_type n){
+                return it -= n;
             }
 
-            //post
-            //old=*this; ind++; return old
-            const_iterator operator++(int){
-                const_iterator old = *this;
-                ind++;
-                return old;
+            //distance between two iterators of the same vector
+            friend difference_type operator-(basic_iterator lhs, basic_iterator rhs){
+                return lhs.ptr - rhs.ptr;
             }
 
-            //pre
-            //ind--; return *this
-            const_iterator& operator--(){
-                ind--;
-                return *this;
-            }
+            //return ptr==rhs.ptr (!= is synthesized)
+            bool operator==(const basic_iterator& rhs) const = default;
 
-            //post
-            //old=*this; ind--; return old
-            const_iterator operator--(int){
-                const_iterator old = *this;
-                ind--;
-                return old;
-            }
+            //ordering by position (<, <=, >, >= are synthesized)
+            auto operator<=>(const basic_iterator& rhs) const = default;
+    };
 
-            //return vec==rhs.vec && ind==rhs.ind
-            bool operator==(const_iterator rhs) const{
-                return (vec == rhs.vec) && (ind == rhs.ind);
-            }
+    using iterator = basic_iterator<T>;
+    using const_iterator = basic_iterator<const T>;
 
-            //return !(*this == rhs)
-            bool operator!=(const_iterator rhs) const{
-                return !(*this == rhs);
-            }
-    };
 public:
     // additional functions of Vector class
-    
-    //return iterator(this, 0)
+
+    //pointer to the first element; [data(), data()+size()) is contiguous
+    T* data(){
+        return elems;
+    }
+
+    //pointer to the first element; [data(), data()+size()) is contiguous
+    const T* data() const{
+        return elems;
+    }
+
+    //return iterator(elems)
     iterator begin(){
-        return iterator(this, 0);
+        return iterator(elems);
     }
 
-    //return iterator(this, sz)
+    //return iterator(elems + sz)
     iterator end(){
-        return iterator(this, sz);
+        return iterator(elems + sz);
     }
 
-    //return const_iterator(this, 0)
+    //return const_iterator(elems)
     const_iterator begin() const{
-        return const_iterator(this, 0);
+        return const_iterator(elems);
     }
 
-    //return const_iterator(this, sz)
+    //return const_iterator(elems + sz)
     const_iterator end() const{
-        return const_iterator(this, sz);
+        return const_iterator(elems + sz);
+    }
+
+    //return const_iterator(elems)
+    const_iterator cbegin() const{
+        return begin();
+    }
+
+    //return const_iterator(elems + sz)
+    const_iterator cend() const{
+        return end();
     }
 
     // Inserts an element immediately before iterator position
-    //insert(it.ind, elem); return it;
-    iterator insert(iterator it, const T& elem){
-        insert(it.ind, elem);
-        return it;
+    //insert(it.ptr - elems, elem); return iterator to the new element
+    //(the buffer may have moved, so it is recomputed from the index)
+    iterator insert(const_iterator it, const T& elem){
+        size_type i = static_cast<size_type>(it.ptr - elems);
+        insert(i, elem);
+        return iterator(elems + i);
+    }
+
+    // Inserts copies of [first, last) before iterator position
+    //insert(it.ptr - elems, first, last); return iterator to the first
+    //inserted element (or pos when the range is empty)
+    template <std::input_iterator It>
+    iterator insert(const_iterator it, It first, It last){
+        size_type i = static_cast<size_type>(it.ptr - elems);
+        insert(i, first, last);
+        return iterator(elems + i);
+    }
+
+    // Inserts count copies of value before iterator position
+    iterator insert(const_iterator it, size_type count, const T& value){
+        size_type i = static_cast<size_type>(it.ptr - elems);
+        insert(i, count, value);
+        return iterator(elems + i);
     }
 
     // Removes the element at the given iterator position
-    //erase(it.ind); return it;
-    iterator erase(iterator it){
-        erase(it.ind);
-        return it;
+    //erase(it.ptr - elems); return iterator to the element that followed
+    iterator erase(const_iterator it){
+        size_type i = static_cast<size_type>(it.ptr - elems);
+        erase(i);
+        return iterator(elems + i);
+    }
+
+    // Removes the elements in [first, last)
+    //erase(first.ptr - elems, last.ptr - elems); return iterator to the
+    //element that followed the range
+    iterator erase(const_iterator first, const_iterator last){
+        size_type i = static_cast<size_type>(first.ptr - elems);
+        erase(i, static_cast<size_type>(last.ptr - elems));
+        return iterator(elems + i);
     }
-    
 
     // Rule of Five
     private:
         //sz=other.sz; cap=other.cap
-        //if cap==0: data=nullptr
-        //else: data=new T[cap]; copy [0..sz)
+        //if cap==0: elems=nullptr
+        //else: elems=allocate(cap); copy-construct [0..sz)
         void clone(const Vector& other){
-            sz = other.sz;
-            cap = other.cap;
-            if (cap == 0) {
-                data = nullptr;
-            } else {
-                data = new T[cap];
-                for (int k = 0; k < sz; k++) {
-                    data[k] = other.data[k];
+            sz = 0;
+            cap = 0;
+            elems = nullptr;
+            inline_storage = false;
+            if (other.cap != 0) {
+                T* temp = allocate(other.cap);
+                try {
+                    copy_construct(other.elems, other.elems + other.sz, temp);
+                } catch (...) {
+                    deallocate(temp, other.cap);
+                    throw;
                 }
+                elems = temp;
+                cap = other.cap;
+                sz = other.sz;
             }
         }
 
+        // this holds no elements (and no heap storage)
         // move other's pointers/sizes into this
         // reset other to empty state
+        // an inline source buffer, or one from an allocator that is not
+        // ours, cannot be stolen: move its elements over
         void transfer(Vector& other){
+            if (other.inline_storage || !(alloc == other.alloc)) {
+                reserve(other.sz);
+                move_construct(other.elems, other.elems + other.sz, elems);
+                sz = other.sz;
+                std::destroy(other.elems, other.elems + other.sz);
+                other.sz = 0;
+                return;
+            }
             sz = other.sz;
             cap = other.cap;
-            data = other.data;
+            elems = other.elems;
+            inline_storage = false;
 
             other.sz = 0;
             other.cap = 0;
-            other.data = nullptr;
+            other.elems = nullptr;
         }
 
     public:
         // Copy constructor
-        Vector(const Vector& other){ 
+        Vector(const Vector& other)
+            : growth(other.growth), shrinking(other.shrinking),
+              alloc(alloc_traits::select_on_container_copy_construction(other.alloc)) {
             clone(other); 
         }
 
+        // Copy constructor allocating from a
+        Vector(const Vector& other, const Allocator& a)
+            : growth(other.growth), shrinking(other.shrinking), alloc(a) {
+            clone(other);
+        }
+
         // Copy assignment
         Vector& operator=(const Vector& other){
             // nothing to be done if self-assignment
             // else deallocate previous and clone
             if (this != &other) {
-                delete[] data;
-                clone(other);
+                growth = other.growth;
+                shrinking = other.shrinking;
+                if constexpr (alloc_traits::propagate_on_container_copy_assignment::value) {
+                    if (!(alloc == other.alloc)) {
+                        // our storage has to go back to the old allocator
+                        release();
+                        sz = 0;
+                        cap = 0;
+                        elems = nullptr;
+                        inline_storage = false;
+                    }
+                    alloc = other.alloc;
+                }
+                if (inline_storage && other.sz <= cap) {
+                    // stay on the inline buffer
+                    std::destroy(elems, elems + sz);
+                    sz = 0;
+                    copy_construct(other.elems, other.elems + other.sz, elems);
+                    sz = other.sz;
+                } else {
+                    release();
+                    clone(other);
+                }
             }
             return *this;
         }
 
-        // Move constructor
-        Vector(Vector&& other){ 
+        // Move constructor - takes the buffer and the allocator along, so
+        // it never allocates (a SmallVector, the only owner of an inline
+        // buffer, uses move_from and cannot be passed as a Vector)
+        Vector(Vector&& other) noexcept
+            : growth(std::move(other.growth)), shrinking(other.shrinking),
+              alloc(std::move(other.alloc)) {
             transfer(other); 
         }
 
+        // Move constructor allocating from a; moves the elements one by
+        // one when a differs from other's allocator
+        Vector(Vector&& other, const Allocator& a)
+            : growth(std::move(other.growth)), shrinking(other.shrinking), alloc(a) {
+            transfer(other);
+        }
+
         // Move assignment
-        Vector& operator=(Vector&& other){
+        Vector& operator=(Vector&& other) noexcept(
+            alloc_traits::propagate_on_container_move_assignment::value ||
+            alloc_traits::is_always_equal::value) {
             // nothing to be done if self-assignment
             // else deallocate previous and transfer
             if (this != &other) {
-                delete[] data;
-                sz = other.sz;
-                cap = other.cap;
-                data = other.data;
-                other.sz = 0;
-                other.cap = 0;
-                other.data = nullptr;
+                release();
+                sz = 0;
+                cap = 0;
+                elems = nullptr;
+                inline_storage = false;
+                growth = std::move(other.growth);
+                shrinking = other.shrinking;
+                if constexpr (alloc_traits::propagate_on_container_move_assignment::value) {
+                    alloc = std::move(other.alloc);
+                }
+                transfer(other);
             }
             return *this;
         }
 
         // deallocate
         ~Vector(){
-            delete[] this->data; 
+            release();
         }
 
     // additional assignment functions
     // Reallocate storage to exactly new_cap (>= sz), moving elements.
-    void reallocate(int new_cap){ // optional helper
-        if (new_cap == cap) {
+    // An inline buffer is never traded for a smaller one.
+    void reallocate(size_type new_cap){ // optional helper
+        if (new_cap == cap || (inline_storage && new_cap < cap)) {
             return;
         }
-        T* temp = new T[new_cap];
-        for (int k = 0; k < sz; k++) {
-            temp[k] = data[k];
+        if constexpr (relocatable) {
+            resize_storage(new_cap);
+        } else {
+            T* temp = allocate(new_cap);
+            try {
+                move_construct(elems, elems + sz, temp);
+            } catch (...) {
+                deallocate(temp, new_cap);
+                throw;
+            }
+            replace_storage(temp, new_cap);
         }
-        delete[] data;
-        data = temp;
-        cap = new_cap;
     }
 
+    // current shrink policy
+    ShrinkPolicy shrink_policy() const {
+        return shrinking;
+    }
+
+    // replace the shrink policy; the divisors must satisfy
+    // 2 <= shrink_divisor <= trigger_divisor so a shrink keeps every element
+    //throw std::invalid_argument("Invalid shrink policy");
+    void set_shrink_policy(ShrinkPolicy policy){
+        if (policy.shrink_divisor < 2 || policy.trigger_divisor < policy.shrink_divisor) {
+            throw std::invalid_argument("Invalid shrink policy");
+        }
+        shrinking = policy;
+    }
+
+    // if sz <= cap/trigger_divisor: reallocate(max(1, cap/shrink_divisor))
+    // does nothing under ShrinkPolicy::never()
     void shrink(){
-        if (cap > 0 && sz <= cap / 4) {
-            int new_cap = std::max(1, cap / 2);
-            reallocate(new_cap);
+        if (shrinking.mode == ShrinkPolicy::Mode::never) {
+            return;
+        }
+        if (cap > 0 && sz <= cap / shrinking.trigger_divisor) {
+            size_type new_cap = std::max<size_type>(1, cap / shrinking.shrink_divisor);
+            shrink_to(new_cap);
         }
     }
     
     // explicitly reduce the cap to sz and keep at least 1 slot
+    // does nothing under ShrinkPolicy::never()
     void shrink_to_fit(){
+        if (shrinking.mode == ShrinkPolicy::Mode::never) {
+            return;
+        }
         if (cap > sz) {
-            int new_cap = std::max(1, sz);
-            reallocate(new_cap);
+            size_type new_cap = std::max<size_type>(1, sz);
+            shrink_to(new_cap);
+        }
+    }
+
+    // this vector's counters, see vector_stats.hpp; all zero unless
+    // DSA_VECTOR_STATS is set
+    VectorStats stats() const {
+        return counters.stats();
+    }
+
+private:
+    // reallocate(new_cap) for the shrink functions, counted as a shrink
+    // when the capacity actually goes down
+    void shrink_to(size_type new_cap) {
+        size_type old_cap = cap;
+        reallocate(new_cap);
+        if (cap < old_cap) {
+            counters.shrank();
         }
     }
 
 }; //end class Vector
+
+namespace pmr{
+
+// dsa::Vector allocating from a std::pmr::memory_resource
+template <typename T, typename Growth = DoublingGrowth, typename SizeType = std::size_t>
+using Vector = dsa::Vector<T, Growth, SizeType, std::pmr::polymorphic_allocator<T>>;
+
+}//end namespace pmr
 }//end namespace dsa
@@ -0,0 +1,153 @@
+#pragma once
+
+#include <atomic>     // std::atomic
+#include <cstddef>    // std::size_t
+#include <cstdint>    // std::uint64_t
+
+// Opt-in instrumentation of Vector's memory traffic.
+// With DSA_VECTOR_STATS defined to nonzero (CMake: -DDSA_VECTOR_STATS=ON)
+// every Vector counts what it does to its storage, per instance and
+// process-wide:
+//     v.stats()                  this vector, since it was constructed
+//     dsa::vector_stats()        all vectors, since start or the last reset
+//     dsa::reset_vector_stats()
+// A vector that makes many small allocations and reallocations is one
+// that wants a reserve() up front.
+// Off by default; then the counters are empty members and every hook is
+// an empty inline function, so Vector's size and code are unchanged and
+// both stats functions return zeros. The macro changes Vector's layout:
+// define it the same way in every translation unit.
+
+#ifndef DSA_VECTOR_STATS
+#define DSA_VECTOR_STATS 0
+#endif
+
+namespace dsa{
+
+inline constexpr bool vector_stats_enabled = DSA_VECTOR_STATS != 0;
+
+struct VectorStats {
+    std::uint64_t allocations{0};     // buffers obtained (a realloc/mremap counts as one)
+    std::uint64_t bytes_allocated{0}; // their total size
+    std::uint64_t reallocations{0};   // buffers replaced by one of another capacity:
+                                      // growth, reserve(), reallocate(), shrinks
+    std::uint64_t shrinks{0};         // of those, the ones that gave capacity back
+    std::uint64_t copies{0};          // elements copy-constructed: push_back, insert and
+                                      // emplace_back of an lvalue T, and in bulk: copying a
+                                      // Vector, range and count insert, append, assign
+    std::uint64_t moves{0};           // elements move-constructed or move-assigned (or
+                                      // relocated): push_back and emplace_back of an
+                                      // rvalue T, moves to a new buffer, and the tail
+                                      // shifts of insert, erase, erase_if, remove_indices
+    std::size_t peak_capacity{0};     // largest capacity, in elements
+};
+
+namespace detail{
+
+// process-wide totals, relaxed atomics
+struct GlobalVectorStats {
+    std::atomic<std::uint64_t> allocations{0};
+    std::atomic<std::uint64_t> bytes_allocated{0};
+    std::atomic<std::uint64_t> reallocations{0};
+    std::atomic<std::uint64_t> shrinks{0};
+    std::atomic<std::uint64_t> copies{0};
+    std::atomic<std::uint64_t> moves{0};
+    std::atomic<std::size_t> peak_capacity{0};
+};
+
+inline GlobalVectorStats& global_vector_stats() {
+    static GlobalVectorStats stats;
+    return stats;
+}
+
+inline void add(std::atomic<std::uint64_t>& counter, std::uint64_t n) {
+    counter.fetch_add(n, std::memory_order_relaxed);
+}
+
+// the per-instance counters inside a Vector, and the hooks it calls
+template <bool Enabled = vector_stats_enabled>
+struct VectorCounters {
+    VectorStats stats() const {
+        return {};
+    }
+
+    void allocated(std::size_t, std::size_t) {}
+    void reallocated() {}
+    void shrank() {}
+    void copied(std::size_t) {}
+    void moved(std::size_t) {}
+};
+
+template <>
+struct VectorCounters<true> {
+    VectorStats counts;
+
+    VectorStats stats() const {
+        return counts;
+    }
+
+    // a buffer of n elements of elem_size bytes
+    void allocated(std::size_t n, std::size_t elem_size) {
+        GlobalVectorStats& global = global_vector_stats();
+        counts.allocations++;
+        counts.bytes_allocated += n * elem_size;
+        add(global.allocations, 1);
+        add(global.bytes_allocated, n * elem_size);
+        if (n > counts.peak_capacity) {
+            counts.peak_capacity = n;
+            std::size_t peak = global.peak_capacity.load(std::memory_order_relaxed);
+            while (n > peak && !global.peak_capacity.compare_exchange_weak(peak, n, std::memory_order_relaxed)) {
+            }
+        }
+    }
+
+    void reallocated() {
+        counts.reallocations++;
+        add(global_vector_stats().reallocations, 1);
+    }
+
+    void shrank() {
+        counts.shrinks++;
+        add(global_vector_stats().shrinks, 1);
+    }
+
+    void copied(std::size_t n) {
+        counts.copies += n;
+        add(global_vector_stats().copies, n);
+    }
+
+    void moved(std::size_t n) {
+        counts.moves += n;
+        add(global_vector_stats().moves, n);
+    }
+};
+
+}//end namespace detail
+
+// totals over every Vector (all element types) since start or the last reset
+inline VectorStats vector_stats() {
+    if constexpr (!vector_stats_enabled) {
+        return {};
+    } else {
+        const detail::GlobalVectorStats& g = detail::global_vector_stats();
+        auto get = [](const auto& counter) { return counter.load(std::memory_order_relaxed); };
+        return {get(g.allocations), get(g.bytes_allocated), get(g.reallocations), get(g.shrinks),
+                get(g.copies), get(g.moves), get(g.peak_capacity)};
+    }
+}
+
+// zero the process-wide totals (per-instance counters are left alone)
+inline void reset_vector_stats() {
+    if constexpr (vector_stats_enabled) {
+        detail::GlobalVectorStats& g = detail::global_vector_stats();
+        g.allocations.store(0, std::memory_order_relaxed);
+        g.bytes_allocated.store(0, std::memory_order_relaxed);
+        g.reallocations.store(0, std::memory_order_relaxed);
+        g.shrinks.store(0, std::memory_order_relaxed);
+        g.copies.store(0, std::memory_order_relaxed);
+        g.moves.store(0, std::memory_order_relaxed);
+        g.peak_capacity.store(0, std::memory_order_relaxed);
+    }
+}
+
+}//end namespace dsa
@@ -0,0 +1,266 @@
+#include "gemm.hpp"
+
+#include <cstddef>  // std::size_t
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#define DSA_GEMM_X86 1
+#include <immintrin.h>
+#endif
+
+// SIMD micro-kernels for dsa::detail::gemm_f32 / gemm_f64.
+// Each kernel is compiled for its own instruction set with a target
+// attribute, so the library itself needs no -mavx flags and still runs
+// on any x86-64; the first call picks the widest kernel the CPU supports.
+//
+// Blocking (per kernel): kc * nr B values are an L1-resident sliver,
+// mc * kc A values an L2-resident block (48 KB L1d / 2 MB L2 class cores).
+
+namespace dsa{
+namespace detail{
+
+namespace {
+
+#if defined(DSA_GEMM_X86)
+
+// ---- AVX2 + FMA: 6 x 16 floats / 6 x 8 doubles, 12 ymm accumulators ----
+
+template <std::size_t MR>
+__attribute__((target("avx2,fma")))
+void kernel_avx2_f32(std::size_t kc, const float* a, const float* b, float* c,
+                     std::size_t ldc, float alpha, float beta) {
+    __m256 acc[MR][2];
+#pragma GCC unroll 16
+    for (std::size_t i = 0; i < MR; i++) {
+        acc[i][0] = _mm256_setzero_ps();
+        acc[i][1] = _mm256_setzero_ps();
+    }
+    for (std::size_t p = 0; p < kc; p++) {
+        __m256 b0 = _mm256_load_ps(b);
+        __m256 b1 = _mm256_load_ps(b + 8);
+#pragma GCC unroll 16
+        for (std::size_t i = 0; i < MR; i++) {
+            __m256 ai = _mm256_broadcast_ss(a + i);
+            acc[i][0] = _mm256_fmadd_ps(ai, b0, acc[i][0]);
+            acc[i][1] = _mm256_fmadd_ps(ai, b1, acc[i][1]);
+        }
+        a += MR;
+        b += 16;
+    }
+    __m256 va = _mm256_set1_ps(alpha);
+    __m256 vb = _mm256_set1_ps(beta);
+#pragma GCC unroll 16
+    for (std::size_t i = 0; i < MR; i++) {
+        float* row = c + i * ldc;
+        __m256 r0 = _mm256_mul_ps(va, acc[i][0]);
+        __m256 r1 = _mm256_mul_ps(va, acc[i][1]);
+        if (beta != 0.0f) {
+            r0 = _mm256_fmadd_ps(vb, _mm256_loadu_ps(row), r0);
+            r1 = _mm256_fmadd_ps(vb, _mm256_loadu_ps(row + 8), r1);
+        }
+        _mm256_storeu_ps(row, r0);
+        _mm256_storeu_ps(row + 8, r1);
+    }
+}
+
+template <std::size_t MR>
+__attribute__((target("avx2,fma")))
+void kernel_avx2_f64(std::size_t kc, const double* a, const double* b, double* c,
+                     std::size_t ldc, double alpha, double beta) {
+    __m256d acc[MR][2];
+#pragma GCC unroll 16
+    for (std::size_t i = 0; i < MR; i++) {
+        acc[i][0] = _mm256_setzero_pd();
+        acc[i][1] = _mm256_setzero_pd();
+    }
+    for (std::size_t p = 0; p < kc; p++) {
+        __m256d b0 = _mm256_load_pd(b);
+        __m256d b1 = _mm256_load_pd(b + 4);
+#pragma GCC unroll 16
+        for (std::size_t i = 0; i < MR; i++) {
+            __m256d ai = _mm256_broadcast_sd(a + i);
+            acc[i][0] = _mm256_fmadd_pd(ai, b0, acc[i][0]);
+            acc[i][1] = _mm256_fmadd_pd(ai, b1, acc[i][1]);
+        }
+        a += MR;
+        b += 8;
+    }
+    __m256d va = _mm256_set1_pd(alpha);
+    __m256d vb = _mm256_set1_pd(beta);
+#pragma GCC unroll 16
+    for (std::size_t i = 0; i < MR; i++) {
+        double* row = c + i * ldc;
+        __m256d r0 = _mm256_mul_pd(va, acc[i][0]);
+        __m256d r1 = _mm256_mul_pd(va, acc[i][1]);
+        if (beta != 0.0) {
+            r0 = _mm256_fmadd_pd(vb, _mm256_loadu_pd(row), r0);
+            r1 = _mm256_fmadd_pd(vb, _mm256_loadu_pd(row + 4), r1);
+        }
+        _mm256_storeu_pd(row, r0);
+        _mm256_storeu_pd(row + 4, r1);
+    }
+}
+
+// ---- AVX-512: 12 x 32 floats / 12 x 16 doubles, 24 zmm accumulators ----
+
+template <std::size_t MR>
+__attribute__((target("avx512f")))
+void kernel_avx512_f32(std::size_t kc, const float* a, const float* b, float* c,
+                       std::size_t ldc, float alpha, float beta) {
+    __m512 acc[MR][2];
+#pragma GCC unroll 16
+    for (std::size_t i = 0; i < MR; i++) {
+        acc[i][0] = _mm512_setzero_ps();
+        acc[i][1] = _mm512_setzero_ps();
+    }
+    for (std::size_t p = 0; p < kc; p++) {
+        __m512 b0 = _mm512_load_ps(b);
+        __m512 b1 = _mm512_load_ps(b + 16);
+#pragma GCC unroll 16
+        for (std::size_t i = 0; i < MR; i++) {
+            __m512 ai = _mm512_set1_ps(a[i]);
+            acc[i][0] = _mm512_fmadd_ps(ai, b0, acc[i][0]);
+            acc[i][1] = _mm512_fmadd_ps(ai, b1, acc[i][1]);
+        }
+        a += MR;
+        b += 32;
+    }
+    __m512 va = _mm512_set1_ps(alpha);
+    __m512 vb = _mm512_set1_ps(beta);
+#pragma GCC unroll 16
+    for (std::size_t i = 0; i < MR; i++) {
+        float* row = c + i * ldc;
+        __m512 r0 = _mm512_mul_ps(va, acc[i][0]);
+        __m512 r1 = _mm512_mul_ps(va, acc[i][1]);
+        if (beta != 0.0f) {
+            r0 = _mm512_fmadd_ps(vb, _mm512_loadu_ps(row), r0);
+            r1 = _mm512_fmadd_ps(vb, _mm512_loadu_ps(row + 16), r1);
+        }
+        _mm512_storeu_ps(row, r0);
+        _mm512_storeu_ps(row + 16, r1);
+    }
+}
+
+template <std::size_t MR>
+__attribute__((target("avx512f")))
+void kernel_avx512_f64(std::size_t kc, const double* a, const double* b, double* c,
+                       std::size_t ldc, double alpha, double beta) {
+    __m512d acc[MR][2];
+#pragma GCC unroll 16
+    for (std::size_t i = 0; i < MR; i++) {
+        acc[i][0] = _mm512_setzero_pd();
+        acc[i][1] = _mm512_setzero_pd();
+    }
+    for (std::size_t p = 0; p < kc; p++) {
+        __m512d b0 = _mm512_load_pd(b);
+        __m512d b1 = _mm512_load_pd(b + 8);
+#pragma GCC unroll 16
+        for (std::size_t i = 0; i < MR; i++) {
+            __m512d ai = _mm512_set1_pd(a[i]);
+            acc[i][0] = _mm512_fmadd_pd(ai, b0, acc[i][0]);
+            acc[i][1] = _mm512_fmadd_pd(ai, b1, acc[i][1]);
+        }
+        a += MR;
+        b += 16;
+    }
+    __m512d va = _mm512_set1_pd(alpha);
+    __m512d vb = _mm512_set1_pd(beta);
+#pragma GCC unroll 16
+    for (std::size_t i = 0; i < MR; i++) {
+        double* row = c + i * ldc;
+        __m512d r0 = _mm512_mul_pd(va, acc[i][0]);
+        __m512d r1 = _mm512_mul_pd(va, acc[i][1]);
+        if (beta != 0.0) {
+            r0 = _mm512_fmadd_pd(vb, _mm512_loadu_pd(row), r0);
+            r1 = _mm512_fmadd_pd(vb, _mm512_loadu_pd(row + 8), r1);
+        }
+        _mm512_storeu_pd(row, r0);
+        _mm512_storeu_pd(row + 8, r1);
+    }
+}
+
+#endif // DSA_GEMM_X86
+
+enum class Isa { scalar, avx2, avx512 };
+
+Isa detect_isa() {
+#if defined(DSA_GEMM_X86)
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx512f")) {
+        return Isa::avx512;
+    }
+    if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma")) {
+        return Isa::avx2;
+    }
+#endif
+    return Isa::scalar;
+}
+
+Isa isa() {
+    static const Isa chosen = detect_isa();
+    return chosen;
+}
+
+template <typename T>
+struct KernelChoice {
+    GemmKernel<T> kernel;
+    GemmBlocking blocking;
+};
+
+// kc * nr * sizeof(T) stays well inside L1, mc * kc * sizeof(T) inside L2
+KernelChoice<float> choose_f32() {
+    switch (isa()) {
+#if defined(DSA_GEMM_X86)
+    case Isa::avx512:
+        return {&kernel_avx512_f32<12>, {12, 32, 256, 240, 4096}};
+    case Isa::avx2:
+        return {&kernel_avx2_f32<6>, {6, 16, 256, 240, 4096}};
+#endif
+    default:
+        return {&gemm_kernel_scalar<float, 4, 16>, {4, 16, 256, 128, 4096}};
+    }
+}
+
+KernelChoice<double> choose_f64() {
+    switch (isa()) {
+#if defined(DSA_GEMM_X86)
+    case Isa::avx512:
+        return {&kernel_avx512_f64<12>, {12, 16, 256, 120, 4096}};
+    case Isa::avx2:
+        return {&kernel_avx2_f64<6>, {6, 8, 256, 120, 4096}};
+#endif
+    default:
+        return {&gemm_kernel_scalar<double, 4, 8>, {4, 8, 256, 128, 4096}};
+    }
+}
+
+} // namespace
+
+const char* gemm_isa() {
+    switch (isa()) {
+    case Isa::avx512:
+        return "avx512";
+    case Isa::avx2:
+        return "avx2";
+    default:
+        return "scalar";
+    }
+}
+
+void gemm_f32(std::size_t m, std::size_t n, std::size_t k, float alpha,
+              const float* a, std::size_t lda, const float* b, std::size_t ldb,
+              float beta, float* c, std::size_t ldc) {
+    static const KernelChoice<float> choice = choose_f32();
+    gemm_blocked<float>(m, n, k, alpha, a, lda, b, ldb, beta, c, ldc,
+                        choice.kernel, choice.blocking);
+}
+
+void gemm_f64(std::size_t m, std::size_t n, std::size_t k, double alpha,
+              const double* a, std::size_t lda, const double* b, std::size_t ldb,
+              double beta, double* c, std::size_t ldc) {
+    static const KernelChoice<double> choice = choose_f64();
+    gemm_blocked<double>(m, n, k, alpha, a, lda, b, ldb, beta, c, ldc,
+                         choice.kernel, choice.blocking);
+}
+
+}//end namespace detail
+}//end namespace dsa
@@ -0,0 +1,194 @@
+#include "thread_pool.hpp"
+
+#include <atomic>   // std::atomic
+#include <cstddef>  // std::size_t
+#include <memory>   // std::unique_ptr, std::make_unique
+#include <mutex>    // std::mutex, std::lock_guard, std::unique_lock
+#include <thread>   // std::thread, std::this_thread
+
+namespace dsa{
+
+namespace {
+
+// the pool and deque the current thread works from, if it is a worker
+thread_local const ThreadPool* current_pool = nullptr;
+thread_local std::size_t current_queue = 0;
+
+} // namespace
+
+ThreadPool::ThreadPool(unsigned threads) {
+    if (threads == 0) {
+        threads = std::thread::hardware_concurrency();
+    }
+    if (threads == 0) {
+        threads = 1;
+    }
+    for (unsigned i = 0; i < threads; i++) {
+        queues.push_back(std::make_unique<Queue>());
+    }
+    workers.reserve(threads - 1);
+    for (unsigned i = 0; i + 1 < threads; i++) {
+        workers.emplace_back([this, i] { worker_loop(i); });
+    }
+}
+
+ThreadPool::~ThreadPool() {
+    stopping.store(true);
+    {
+        std::lock_guard<std::mutex> guard(sleep_lock);
+    }
+    wake.notify_all();
+    for (std::thread& t : workers) {
+        t.join();
+    }
+}
+
+std::size_t ThreadPool::own_queue() const {
+    return current_pool == this ? current_queue : queues.size() - 1;
+}
+
+void ThreadPool::push(std::size_t queue, const Task& task) {
+    {
+        std::lock_guard<std::mutex> guard(queues[queue]->lock);
+        queues[queue]->tasks.push_back(task);
+    }
+    queued.fetch_add(1);
+    // a worker registers as a sleeper before it checks queued, so either
+    // it sees this task or we see it and wake it
+    if (sleepers.load() > 0) {
+        {
+            std::lock_guard<std::mutex> guard(sleep_lock);
+        }
+        wake.notify_one();
+    }
+}
+
+bool ThreadPool::try_get(std::size_t queue, Task& task) {
+    {
+        Queue& own = *queues[queue];
+        std::lock_guard<std::mutex> guard(own.lock);
+        if (!own.tasks.empty()) {
+            task = own.tasks.back();
+            own.tasks.pop_back();
+            queued.fetch_sub(1);
+            return true;
+        }
+    }
+    std::size_t count = queues.size();
+    for (std::size_t i = 1; i < count; i++) {
+        Queue& victim = *queues[(queue + i) % count];
+        std::lock_guard<std::mutex> guard(victim.lock);
+        if (!victim.tasks.empty()) {
+            task = victim.tasks.front();
+            victim.tasks.pop_front();
+            queued.fetch_sub(1);
+            return true;
+        }
+    }
+    return false;
+}
+
+void ThreadPool::execute(Task task, std::size_t queue) {
+    Job& job = *task.job;
+    while (task.end - task.begin > job.grain) {
+        std::size_t mid = task.begin + (task.end - task.begin) / 2;
+        push(queue, Task{&job, mid, task.end});
+        task.end = mid;
+    }
+    if (!job.failed.load(std::memory_order_relaxed)) {
+        try {
+            job.fn(job.ctx, task.begin, task.end);
+        } catch (...) {
+            bool expected = false;
+            if (job.failed.compare_exchange_strong(expected, true)) {
+                job.error = std::current_exception();
+            }
+        }
+    }
+    // the job may be gone as soon as remaining reaches zero
+    job.remaining.fetch_sub(task.end - task.begin, std::memory_order_acq_rel);
+}
+
+void ThreadPool::run(RangeFn fn, void* ctx, std::size_t n, std::size_t grain) {
+    Job job{fn, ctx, grain, {n}, {false}, {}};
+    std::size_t queue = own_queue();
+    execute(Task{&job, 0, n}, queue);
+    while (job.remaining.load(std::memory_order_acquire) != 0) {
+        Task task;
+        if (try_get(queue, task)) {
+            execute(task, queue);
+        } else {
+            std::this_thread::yield();
+        }
+    }
+    if (job.error) {
+        std::rethrow_exception(job.error);
+    }
+}
+
+void ThreadPool::worker_loop(std::size_t index) {
+    current_pool = this;
+    current_queue = index;
+    while (true) {
+        Task task;
+        if (try_get(index, task)) {
+            execute(task, index);
+            continue;
+        }
+        std::unique_lock<std::mutex> guard(sleep_lock);
+        sleepers.fetch_add(1);
+        wake.wait(guard, [this] { return queued.load() > 0 || stopping.load(); });
+        sleepers.fetch_sub(1);
+        if (stopping.load() && queued.load() == 0) {
+            return;
+        }
+    }
+}
+
+namespace parallel{
+
+namespace {
+
+std::mutex shared_lock;                  // creation and replacement
+std::unique_ptr<ThreadPool> shared_pool;
+std::atomic<ThreadPool*> current{nullptr}; // shared_pool, read without the lock
+std::atomic<std::size_t> shared_grain{std::size_t(1) << 16};
+
+} // namespace
+
+// every Matrix operation gets here, from any number of threads: once the
+// pool exists this is one acquire load, no lock
+ThreadPool& pool() {
+    if (ThreadPool* p = current.load(std::memory_order_acquire)) {
+        return *p;
+    }
+    std::lock_guard<std::mutex> guard(shared_lock);
+    if (!shared_pool) {
+        shared_pool = std::make_unique<ThreadPool>();
+        current.store(shared_pool.get(), std::memory_order_release);
+    }
+    return *shared_pool;
+}
+
+void set_threads(unsigned n) {
+    std::lock_guard<std::mutex> guard(shared_lock);
+    current.store(nullptr, std::memory_order_release);
+    shared_pool.reset();
+    shared_pool = std::make_unique<ThreadPool>(n);
+    current.store(shared_pool.get(), std::memory_order_release);
+}
+
+unsigned threads() {
+    return pool().size();
+}
+
+void set_grain(std::size_t elements) {
+    shared_grain.store(elements == 0 ? 1 : elements);
+}
+
+std::size_t grain() {
+    return shared_grain.load();
+}
+
+}//end namespace parallel
+}//end namespace dsa
@@ -0,0 +1,193 @@
+#include "transpose.hpp"
+
+#include <cstddef>  // std::size_t
+#include <cstdint>  // std::uint32_t
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#define DSA_TRANSPOSE_X86 1
+#include <immintrin.h>
+#endif
+
+// In-register tile transposes for 4-byte elements. Float and int data
+// are both moved as raw 32-bit words. The 8x8 kernel needs AVX and is
+// chosen at runtime; the 4x4 kernel only needs SSE, which every x86-64
+// has; elsewhere the scalar tiles from transpose.hpp are used.
+
+namespace dsa{
+namespace detail{
+
+namespace {
+
+using word = std::uint32_t;
+
+#if defined(DSA_TRANSPOSE_X86)
+
+struct Sse4Tiles {
+    static constexpr std::size_t tile = 4;
+
+    static void load(const word* p, std::size_t ld, __m128 r[4]) {
+        for (int i = 0; i < 4; i++) {
+            r[i] = _mm_loadu_ps(reinterpret_cast<const float*>(p + i * ld));
+        }
+    }
+
+    static void store(word* p, std::size_t ld, const __m128 r[4]) {
+        for (int i = 0; i < 4; i++) {
+            _mm_storeu_ps(reinterpret_cast<float*>(p + i * ld), r[i]);
+        }
+    }
+
+    void transpose(const word* src, std::size_t lds, word* dst, std::size_t ldd) const {
+        __m128 r[4];
+        load(src, lds, r);
+        _MM_TRANSPOSE4_PS(r[0], r[1], r[2], r[3]);
+        store(dst, ldd, r);
+    }
+
+    void swap(word* p, word* q, std::size_t ld) const {
+        __m128 a[4];
+        __m128 b[4];
+        load(p, ld, a);
+        load(q, ld, b);
+        _MM_TRANSPOSE4_PS(a[0], a[1], a[2], a[3]);
+        _MM_TRANSPOSE4_PS(b[0], b[1], b[2], b[3]);
+        store(q, ld, a);
+        store(p, ld, b);
+    }
+
+    void transpose_diagonal(word* p, std::size_t ld) const {
+        transpose(p, ld, p, ld);
+    }
+};
+
+// 8x8 in registers: unpack pairs of rows, shuffle pairs of pairs, then
+// swap 128-bit halves across the two groups of four rows
+__attribute__((target("avx")))
+inline void transpose8x8(__m256 r[8]) {
+    __m256 t0 = _mm256_unpacklo_ps(r[0], r[1]);
+    __m256 t1 = _mm256_unpackhi_ps(r[0], r[1]);
+    __m256 t2 = _mm256_unpacklo_ps(r[2], r[3]);
+    __m256 t3 = _mm256_unpackhi_ps(r[2], r[3]);
+    __m256 t4 = _mm256_unpacklo_ps(r[4], r[5]);
+    __m256 t5 = _mm256_unpackhi_ps(r[4], r[5]);
+    __m256 t6 = _mm256_unpacklo_ps(r[6], r[7]);
+    __m256 t7 = _mm256_unpackhi_ps(r[6], r[7]);
+    __m256 s0 = _mm256_shuffle_ps(t0, t2, _MM_SHUFFLE(1, 0, 1, 0));
+    __m256 s1 = _mm256_shuffle_ps(t0, t2, _MM_SHUFFLE(3, 2, 3, 2));
+    __m256 s2 = _mm256_shuffle_ps(t1, t3, _MM_SHUFFLE(1, 0, 1, 0));
+    __m256 s3 = _mm256_shuffle_ps(t1, t3, _MM_SHUFFLE(3, 2, 3, 2));
+    __m256 s4 = _mm256_shuffle_ps(t4, t6, _MM_SHUFFLE(1, 0, 1, 0));
+    __m256 s5 = _mm256_shuffle_ps(t4, t6, _MM_SHUFFLE(3, 2, 3, 2));
+    __m256 s6 = _mm256_shuffle_ps(t5, t7, _MM_SHUFFLE(1, 0, 1, 0));
+    __m256 s7 = _mm256_shuffle_ps(t5, t7, _MM_SHUFFLE(3, 2, 3, 2));
+    r[0] = _mm256_permute2f128_ps(s0, s4, 0x20);
+    r[1] = _mm256_permute2f128_ps(s1, s5, 0x20);
+    r[2] = _mm256_permute2f128_ps(s2, s6, 0x20);
+    r[3] = _mm256_permute2f128_ps(s3, s7, 0x20);
+    r[4] = _mm256_permute2f128_ps(s0, s4, 0x31);
+    r[5] = _mm256_permute2f128_ps(s1, s5, 0x31);
+    r[6] = _mm256_permute2f128_ps(s2, s6, 0x31);
+    r[7] = _mm256_permute2f128_ps(s3, s7, 0x31);
+}
+
+struct Avx8Tiles {
+    static constexpr std::size_t tile = 8;
+
+    __attribute__((target("avx")))
+    static void load(const word* p, std::size_t ld, __m256 r[8]) {
+        for (int i = 0; i < 8; i++) {
+            r[i] = _mm256_loadu_ps(reinterpret_cast<const float*>(p + i * ld));
+        }
+    }
+
+    __attribute__((target("avx")))
+    static void store(word* p, std::size_t ld, const __m256 r[8]) {
+        for (int i = 0; i < 8; i++) {
+            _mm256_storeu_ps(reinterpret_cast<float*>(p + i * ld), r[i]);
+        }
+    }
+
+    __attribute__((target("avx")))
+    void transpose(const word* src, std::size_t lds, word* dst, std::size_t ldd) const {
+        __m256 r[8];
+        load(src, lds, r);
+        transpose8x8(r);
+        store(dst, ldd, r);
+    }
+
+    __attribute__((target("avx")))
+    void swap(word* p, word* q, std::size_t ld) const {
+        __m256 a[8];
+        __m256 b[8];
+        load(p, ld, a);
+        load(q, ld, b);
+        transpose8x8(a);
+        transpose8x8(b);
+        store(q, ld, a);
+        store(p, ld, b);
+    }
+
+    __attribute__((target("avx")))
+    void transpose_diagonal(word* p, std::size_t ld) const {
+        transpose(p, ld, p, ld);
+    }
+};
+
+bool has_avx() {
+    static const bool avx = [] {
+        __builtin_cpu_init();
+        return __builtin_cpu_supports("avx") != 0;
+    }();
+    return avx;
+}
+
+#endif // DSA_TRANSPOSE_X86
+
+template <typename Tiles>
+void rows_with(const word* src, std::size_t lds, word* dst, std::size_t ldd,
+               std::size_t r0, std::size_t r1, std::size_t cols) {
+    transpose_recursive(src, lds, dst, ldd, r0, r1, std::size_t(0), cols, Tiles{});
+}
+
+template <typename Tiles>
+void in_place_with(word* a, std::size_t ld, std::size_t n, std::size_t r0, std::size_t r1) {
+    Tiles tiles;
+    transpose_diagonal_recursive(a, ld, r0, r1, tiles);
+    if (r1 < n) {
+        transpose_swap_recursive(a, ld, r0, r1, r1, n, tiles);
+    }
+}
+
+} // namespace
+
+void transpose_rows_32(const void* src, std::size_t lds, void* dst, std::size_t ldd,
+                       std::size_t r0, std::size_t r1, std::size_t cols) {
+    const word* s = static_cast<const word*>(src);
+    word* d = static_cast<word*>(dst);
+#if defined(DSA_TRANSPOSE_X86)
+    if (has_avx()) {
+        rows_with<Avx8Tiles>(s, lds, d, ldd, r0, r1, cols);
+    } else {
+        rows_with<Sse4Tiles>(s, lds, d, ldd, r0, r1, cols);
+    }
+#else
+    rows_with<ScalarTiles<word>>(s, lds, d, ldd, r0, r1, cols);
+#endif
+}
+
+void transpose_in_place_rows_32(void* a, std::size_t ld, std::size_t n,
+                                std::size_t r0, std::size_t r1) {
+    word* p = static_cast<word*>(a);
+#if defined(DSA_TRANSPOSE_X86)
+    if (has_avx()) {
+        in_place_with<Avx8Tiles>(p, ld, n, r0, r1);
+    } else {
+        in_place_with<Sse4Tiles>(p, ld, n, r0, r1);
+    }
+#else
+    in_place_with<ScalarTiles<word>>(p, ld, n, r0, r1);
+#endif
+}
+
+}//end namespace detail
+}//end namespace dsa
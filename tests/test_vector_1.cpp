@@ -1,7 +1,13 @@
 #define CATCH_CONFIG_MAIN
 #include "catch2/catch.hpp"
 #include "vector.hpp"
+#include <cstdint>
 #include <stdexcept>
+#include <type_traits>
+#include <vector>
+#if defined(__GLIBC__)
+#include <malloc.h>  // malloc_usable_size
+#endif
 
 TEST_CASE("Default constructor creates empty vector") {
     dsa::Vector<int> v;
@@ -133,7 +139,7 @@ TEST_CASE("Push back function") {
         // Initial capacity is 0, should grow to 1, then 2, then 4, etc.
         for (int i = 0; i < 10; ++i) {
             v.push_back(i * 10);
-            REQUIRE(v.size() == i + 1);
+            REQUIRE(v.size() == static_cast<std::size_t>(i + 1));
             REQUIRE(v[i] == i * 10);
         }
         REQUIRE(v.capacity() >= 10);
@@ -254,7 +260,7 @@ TEST_CASE("Reserve function") {
     
     SECTION("Smaller reserve doesn't reduce capacity") {
         v.reserve(10);
-        int old_cap = v.capacity();
+        std::size_t old_cap = v.capacity();
         
         v.reserve(5); // Should not reduce capacity
         REQUIRE(v.capacity() == old_cap);
@@ -269,7 +275,7 @@ TEST_CASE("Shrink function") {
         for (int i = 0; i < 10; ++i) {
             v.push_back(i);
         }
-        int original_cap = v.capacity();
+        std::size_t original_cap = v.capacity();
         
         // Remove elements until size <= capacity/4
         while (v.size() > original_cap / 4) {
@@ -285,7 +291,7 @@ TEST_CASE("Shrink function") {
     SECTION("No shrink when size > capacity/4") {
         v.push_back(1);
         v.push_back(2);
-        int original_cap = v.capacity();
+        std::size_t original_cap = v.capacity();
         
         v.shrink(); // Should not shrink since size > capacity/4
         REQUIRE(v.capacity() == original_cap);
@@ -299,7 +305,7 @@ TEST_CASE("Shrink to fit function") {
         for (int i = 0; i < 5; ++i) {
             v.push_back(i);
         }
-        int original_cap = v.capacity();
+        std::size_t original_cap = v.capacity();
         
         // Remove some elements to create unused capacity
         v.pop_back();
@@ -357,3 +363,292 @@ TEST_CASE("Integration test - complex operations") {
         REQUIRE_FALSE(v.empty());
     }
 }
+
+// element type that counts how it was constructed
+struct Counted {
+    static inline int copies = 0;
+    static inline int moves = 0;
+    int value{0};
+
+    Counted(int v) : value(v) {}
+    Counted(const Counted& other) : value(other.value) { copies++; }
+    Counted(Counted&& other) noexcept : value(other.value) { moves++; }
+    Counted& operator=(const Counted& other) { value = other.value; copies++; return *this; }
+    Counted& operator=(Counted&& other) noexcept { value = other.value; moves++; return *this; }
+
+    static void reset() { copies = 0; moves = 0; }
+};
+
+TEST_CASE("Emplace back and rvalue push back") {
+    dsa::Vector<Counted> v;
+
+    SECTION("emplace_back constructs in place") {
+        v.reserve(4);
+        Counted::reset();
+        v.emplace_back(1);
+        Counted& last = v.emplace_back(2);
+        REQUIRE(Counted::copies == 0);
+        REQUIRE(Counted::moves == 0);
+        REQUIRE(&last == &v.back());
+        REQUIRE(v[0].value == 1);
+        REQUIRE(v[1].value == 2);
+    }
+
+    SECTION("rvalue push_back moves instead of copying") {
+        v.reserve(2);
+        Counted::reset();
+        v.push_back(Counted(7));
+        REQUIRE(Counted::copies == 0);
+        REQUIRE(Counted::moves == 1);
+        REQUIRE(v[0].value == 7);
+    }
+
+    SECTION("lvalue push_back copies once") {
+        v.reserve(2);
+        Counted c(3);
+        Counted::reset();
+        v.push_back(c);
+        REQUIRE(Counted::copies == 1);
+        REQUIRE(Counted::moves == 0);
+    }
+
+    SECTION("growth moves existing elements") {
+        Counted::reset();
+        for (int i = 0; i < 100; i++) {
+            v.emplace_back(i);
+        }
+        REQUIRE(Counted::copies == 0);
+        for (int i = 0; i < 100; i++) {
+            REQUIRE(v[i].value == i);
+        }
+    }
+
+    SECTION("push_back of an element of the same vector") {
+        v.emplace_back(5);
+        v.shrink_to_fit();
+        v.push_back(v[0]);  // forces reallocation while referencing v[0]
+        REQUIRE(v.size() == 2);
+        REQUIRE(v[1].value == 5);
+    }
+
+    SECTION("nested vectors are moved, not deep-copied") {
+        dsa::Vector<dsa::Vector<Counted>> rows;
+        dsa::Vector<Counted> row;
+        row.emplace_back(1);
+        row.emplace_back(2);
+        Counted::reset();
+        rows.push_back(std::move(row));
+        for (int i = 0; i < 10; i++) {
+            rows.emplace_back();
+            rows.back().emplace_back(i);
+        }
+        REQUIRE(Counted::copies == 0);
+        REQUIRE(rows[0].size() == 2);
+        REQUIRE(row.size() == 0); // NOLINT: intentional use after move
+    }
+}
+
+TEST_CASE("Growth policies") {
+    SECTION("Default doubles capacity") {
+        dsa::Vector<int> v;
+        std::size_t expected[] = {1, 2, 4, 4, 8, 8, 8, 8, 16};
+        for (int i = 0; i < 9; ++i) {
+            v.push_back(i);
+            REQUIRE(v.capacity() == expected[i]);
+        }
+    }
+
+    SECTION("1.5x factor") {
+        dsa::Vector<int, dsa::OneAndHalfGrowth> v;
+        std::size_t expected[] = {1, 2, 3, 4, 6, 6, 9, 9, 9, 13};
+        for (int i = 0; i < 10; ++i) {
+            v.push_back(i);
+            REQUIRE(v.capacity() == expected[i]);
+        }
+    }
+
+    SECTION("Fixed chunk step") {
+        dsa::Vector<int, dsa::ChunkGrowth<8>> v;
+        for (int i = 0; i < 17; ++i) {
+            v.insert(v.size(), i);
+        }
+        REQUIRE(v.capacity() == 24);
+        REQUIRE(v[16] == 16);
+    }
+
+    SECTION("Page rounded fills the allocator block") {
+        dsa::Vector<double, dsa::PageRoundedGrowth> v;
+        v.push_back(1.0);
+        REQUIRE(v.capacity() == 3);  // malloc's smallest chunk: 32 bytes, 24 usable
+        dsa::Vector<char, dsa::PageRoundedGrowth> chars;
+        chars.push_back('a');
+        REQUIRE(chars.capacity() == 24);
+        dsa::Vector<int, dsa::PageRoundedGrowth> ints;
+        ints.push_back(1);
+        REQUIRE(ints.capacity() == 6);
+        for (int i = 0; i < 1000; ++i) {
+            v.push_back(i);
+        }
+        std::size_t bytes = v.capacity() * sizeof(double) + sizeof(std::size_t);
+        REQUIRE(bytes % 4096 == 0);
+#if defined(__GLIBC__)
+        // against the real block from the first push, through the
+        // mmap-served sizes too (below DSA_MREMAP_THRESHOLD, where the
+        // buffer is malloc's)
+        dsa::Vector<double, dsa::PageRoundedGrowth> w;
+        while (w.capacity() * sizeof(double) < (std::size_t(8) << 20)) {
+            std::size_t old_cap = w.capacity();
+            while (w.capacity() == old_cap) {
+                w.push_back(0.5);
+            }
+            std::size_t used = w.capacity() * sizeof(double);
+            std::size_t usable = malloc_usable_size(w.data());
+            REQUIRE(usable >= used);
+            REQUIRE(usable - used < 2 * sizeof(std::size_t));
+        }
+#endif
+    }
+
+    SECTION("User-defined callable") {
+        auto plus_three = [](std::size_t cap) { return cap + 3; };
+        dsa::Vector<int, decltype(plus_three)> v(plus_three);
+        for (int i = 0; i < 7; ++i) {
+            v.push_back(i);
+        }
+        REQUIRE(v.capacity() == 9);
+    }
+
+    SECTION("Policy results below cap+1 still grow") {
+        auto stuck = [](std::size_t cap) { return cap; };
+        dsa::Vector<int, decltype(stuck)> v(stuck);
+        for (int i = 0; i < 3; ++i) {
+            v.push_back(i);
+        }
+        REQUIRE(v.capacity() == 3);
+        REQUIRE(v[2] == 2);
+    }
+}
+
+TEST_CASE("Shrink policies") {
+    dsa::Vector<int> v;
+    for (int i = 0; i < 16; ++i) {
+        v.push_back(i);
+    }
+    REQUIRE(v.capacity() == 16);
+
+    SECTION("Default shrinks automatically at a quarter") {
+        while (v.size() > 4) {
+            v.pop_back();
+        }
+        REQUIRE(v.capacity() == 8);
+    }
+
+    SECTION("Explicit only keeps capacity until asked") {
+        v.set_shrink_policy(dsa::ShrinkPolicy::explicit_only());
+        while (v.size() > 2) {
+            v.erase(0);
+        }
+        REQUIRE(v.capacity() == 16);
+        v.shrink();
+        REQUIRE(v.capacity() == 8);
+        v.shrink_to_fit();
+        REQUIRE(v.capacity() == 2);
+        REQUIRE(v[0] == 14);
+        REQUIRE(v[1] == 15);
+    }
+
+    SECTION("Never ignores explicit requests too") {
+        v.set_shrink_policy(dsa::ShrinkPolicy::never());
+        while (!v.empty()) {
+            v.pop_back();
+        }
+        v.shrink();
+        v.shrink_to_fit();
+        REQUIRE(v.capacity() == 16);
+    }
+
+    SECTION("Configurable thresholds") {
+        v.set_shrink_policy(dsa::ShrinkPolicy::automatic(8, 4));
+        while (v.size() > 3) {
+            v.pop_back();
+        }
+        REQUIRE(v.capacity() == 16);
+        v.pop_back();
+        REQUIRE(v.capacity() == 4);
+        REQUIRE(v.back() == 1);
+    }
+
+    SECTION("Invalid thresholds are rejected") {
+        REQUIRE_THROWS_AS(v.set_shrink_policy(dsa::ShrinkPolicy::automatic(4, 1)), std::invalid_argument);
+        REQUIRE_THROWS_AS(v.set_shrink_policy(dsa::ShrinkPolicy::automatic(2, 4)), std::invalid_argument);
+    }
+
+    SECTION("Copies keep the policy") {
+        v.set_shrink_policy(dsa::ShrinkPolicy::never());
+        dsa::Vector<int> copy(v);
+        REQUIRE(copy.shrink_policy().mode == dsa::ShrinkPolicy::Mode::never);
+    }
+}
+
+TEST_CASE("Size type and growth near the limit") {
+    SECTION("Default size type is std::size_t") {
+        STATIC_REQUIRE(std::is_same_v<dsa::Vector<int>::size_type, std::size_t>);
+        STATIC_REQUIRE(dsa::Vector<int>::max_size() == SIZE_MAX / sizeof(int));
+    }
+
+    SECTION("Narrow size type keeps the object compact") {
+        using Compact = dsa::Vector<int, dsa::DoublingGrowth, std::uint32_t>;
+        STATIC_REQUIRE(sizeof(Compact) < sizeof(dsa::Vector<int>));
+        STATIC_REQUIRE(Compact::max_size() == UINT32_MAX);
+    }
+
+    SECTION("Growth clamps to max_size and then throws") {
+        dsa::Vector<char, dsa::DoublingGrowth, std::uint8_t> v;
+        for (int i = 0; i < 255; ++i) {
+            v.push_back(static_cast<char>(i));
+        }
+        REQUIRE(v.size() == 255);
+        REQUIRE(v.capacity() == 255);  // doubling 128 would give 256
+        REQUIRE_THROWS_AS(v.push_back('x'), std::length_error);
+        REQUIRE_THROWS_AS(v.insert(0, 'x'), std::length_error);
+        REQUIRE(v.size() == 255);
+        REQUIRE(v[254] == static_cast<char>(254));
+    }
+
+    SECTION("Assigning a range past max_size throws") {
+        dsa::Vector<int, dsa::DoublingGrowth, std::uint8_t> v = {1, 2, 3};
+        std::vector<int> big(300, 7);
+        REQUIRE_THROWS_AS(v.assign(big.begin(), big.end()), std::length_error);
+        REQUIRE(v.size() == 3);
+        REQUIRE(v[2] == 3);
+        REQUIRE_THROWS_AS(v.insert(0, big.begin(), big.end()), std::length_error);
+        REQUIRE_THROWS_AS(v.append(big.begin(), big.end()), std::length_error);
+        REQUIRE(v.size() == 3);
+        std::vector<int> fits(255, 7);
+        v.assign(fits.begin(), fits.end());
+        REQUIRE(v.size() == 255);
+        REQUIRE(v[254] == 7);
+    }
+
+    SECTION("Reserve past max_size throws") {
+        dsa::Vector<char, dsa::DoublingGrowth, std::uint8_t> v;
+        REQUIRE_NOTHROW(v.reserve(255));
+        dsa::Vector<int> w;
+        REQUIRE_THROWS_AS(w.reserve(SIZE_MAX), std::length_error);
+    }
+
+    SECTION("Index arguments past the end throw") {
+        dsa::Vector<int, dsa::DoublingGrowth, std::uint16_t> v;
+        v.push_back(1);
+        REQUIRE_THROWS_AS(v.at(1), std::out_of_range);
+        REQUIRE_THROWS_AS(v.at(-1), std::out_of_range);
+        REQUIRE_THROWS_AS(v.erase(-1), std::out_of_range);
+    }
+
+    SECTION("Built-in policies saturate instead of wrapping") {
+        REQUIRE(dsa::DoublingGrowth{}(SIZE_MAX / 2 + 1) == SIZE_MAX);
+        REQUIRE(dsa::OneAndHalfGrowth{}(SIZE_MAX - 1) == SIZE_MAX);
+        REQUIRE(dsa::ChunkGrowth<64>{}(SIZE_MAX - 10) == SIZE_MAX);
+        REQUIRE(dsa::PageRoundedGrowth{}(SIZE_MAX / 4, 8) >= SIZE_MAX / 4);
+    }
+}
@@ -1,9 +1,30 @@
 // test_vector_iterator.cpp
 //#define CATCH_CONFIG_MAIN // must be in one
 #include "catch2/catch.hpp"
-#include <algorithm>  //for std::max
+#include <algorithm>  //for std::max, std::sort
+#include <functional> //for std::greater
+#include <iterator>
+#include <list>
+#include <sstream>
 #include "vector.hpp"
 #include "matrix.hpp"
+#include "small_vector.hpp"
+#include "sparse_matrix.hpp"
+#include "thread_pool.hpp"
+#include <atomic>
+#include <stdexcept>
+#include <vector>
+#include <memory_resource>
+#include <cstdint>
+#include <numeric>
+#include <span>
+#include <string>
+#include <thread>
+#include <tuple>
+#include <type_traits>
+#if defined(__linux__)
+#include <sys/resource.h>  // getrusage
+#endif
 
 TEST_CASE("non-const iterator dereference") {
     dsa::Vector<int> v; bool ok{true};
@@ -248,7 +269,7 @@ TEST_CASE("Vector Rule of Five", "[vector]") {
         
         dsa::Vector<int> copy(original);
         REQUIRE(copy.size() == original.size());
-        for(int i = 0; i < original.size(); i++) {
+        for(std::size_t i = 0; i < original.size(); i++) {
             REQUIRE(copy[i] == original[i]);
         }
         
@@ -267,7 +288,7 @@ TEST_CASE("Vector Rule of Five", "[vector]") {
         copy = original;
         
         REQUIRE(copy.size() == original.size());
-        for(int i = 0; i < original.size(); i++) {
+        for(std::size_t i = 0; i < original.size(); i++) {
             REQUIRE(copy[i] == original[i]);
         }
     }
@@ -298,9 +319,18 @@ TEST_CASE("Vector Rule of Five", "[vector]") {
     }
 }
 
-TEST_CASE("Matrix Basic Operations", "[matrix]") {
+// every matrix test runs for each supported element type
+using MatrixTypes = std::tuple<float, double, std::int8_t, std::int16_t, int, std::int64_t>;
+
+TEST_CASE("dsa::Matrix defaults to int elements", "[matrix]") {
+    dsa::Matrix mat(2, 2);
+    STATIC_REQUIRE(std::is_same_v<decltype(mat), dsa::Matrix<int>>);
+    STATIC_REQUIRE(std::is_same_v<dsa::Matrix<>, dsa::Matrix<int>>);
+}
+
+TEMPLATE_LIST_TEST_CASE("Matrix Basic Operations", "[matrix]", MatrixTypes) {
     SECTION("Valid matrix construction") {
-        dsa::Matrix mat(2, 3);
+        dsa::Matrix<TestType> mat(2, 3);
         REQUIRE_NOTHROW(mat(0, 0) = 1);
         REQUIRE_NOTHROW(mat(1, 2) = 6);
         
@@ -310,14 +340,14 @@ TEST_CASE("Matrix Basic Operations", "[matrix]") {
     }
     
     SECTION("Invalid matrix construction") {
-        REQUIRE_THROWS_AS(dsa::Matrix(-1, 2), std::out_of_range);
-        REQUIRE_THROWS_AS(dsa::Matrix(2, -1), std::out_of_range);
-        REQUIRE_THROWS_AS(dsa::Matrix(-1, -1), std::out_of_range);
+        REQUIRE_THROWS_AS(dsa::Matrix<TestType>(-1, 2), std::out_of_range);
+        REQUIRE_THROWS_AS(dsa::Matrix<TestType>(2, -1), std::out_of_range);
+        REQUIRE_THROWS_AS(dsa::Matrix<TestType>(-1, -1), std::out_of_range);
     }
     
     SECTION("Matrix addition") {
-        dsa::Matrix mat1(2, 2);
-        dsa::Matrix mat2(2, 2);
+        dsa::Matrix<TestType> mat1(2, 2);
+        dsa::Matrix<TestType> mat2(2, 2);
         
         // Initialize matrices
         mat1(0, 0) = 1; mat1(0, 1) = 2;
@@ -326,7 +356,7 @@ TEST_CASE("Matrix Basic Operations", "[matrix]") {
         mat2(0, 0) = 5; mat2(0, 1) = 6;
         mat2(1, 0) = 7; mat2(1, 1) = 8;
         
-        dsa::Matrix result = mat1 + mat2;
+        dsa::Matrix<TestType> result = mat1 + mat2;
         
         REQUIRE(result(0, 0) == 6);
         REQUIRE(result(0, 1) == 8);
@@ -335,31 +365,31 @@ TEST_CASE("Matrix Basic Operations", "[matrix]") {
     }
     
     SECTION("Matrix addition dimension mismatch") {
-        dsa::Matrix mat1(2, 2);
-        dsa::Matrix mat2(3, 3);
+        dsa::Matrix<TestType> mat1(2, 2);
+        dsa::Matrix<TestType> mat2(3, 3);
         
         REQUIRE_THROWS_AS(mat1 + mat2, std::out_of_range);
     }
 }
 
-TEST_CASE("Matrix Edge Cases", "[matrix]") {
+TEMPLATE_LIST_TEST_CASE("Matrix Edge Cases", "[matrix]", MatrixTypes) {
     SECTION("Zero dimension matrix") {
-        REQUIRE_NOTHROW(dsa::Matrix(0, 0));
-        REQUIRE_NOTHROW(dsa::Matrix(0, 5));
-        REQUIRE_NOTHROW(dsa::Matrix(5, 0));
+        REQUIRE_NOTHROW(dsa::Matrix<TestType>(0, 0));
+        REQUIRE_NOTHROW(dsa::Matrix<TestType>(0, 5));
+        REQUIRE_NOTHROW(dsa::Matrix<TestType>(5, 0));
     }
     
     SECTION("Single element matrix") {
-        dsa::Matrix mat(1, 1);
+        dsa::Matrix<TestType> mat(1, 1);
         mat(0, 0) = 42;
         REQUIRE(mat(0, 0) == 42);
     }
     
     SECTION("Large matrix") {
-        dsa::Matrix mat(10, 10);
+        dsa::Matrix<TestType> mat(10, 10);
         for(int i = 0; i < 10; i++) {
             for(int j = 0; j < 10; j++) {
-                mat(i, j) = i * 10 + j;
+                mat(i, j) = static_cast<TestType>(i * 10 + j);
             }
         }
         
@@ -389,3 +419,1489 @@ TEST_CASE("Integration: Vector of Vectors as Matrix", "[integration]") {
         }
     }
 }
+
+TEST_CASE("Trivially copyable elements are shifted in bulk", "[vector]") {
+    struct Point { int x; float y; };
+    dsa::Vector<Point> vec;
+    for (int i = 0; i < 8; i++) {
+        vec.push_back(Point{i, i * 0.5f});
+    }
+
+    vec.insert(0, Point{-1, -0.5f});
+    vec.insert(5, Point{100, 50.0f});
+    REQUIRE(vec.size() == 10);
+    REQUIRE(vec[0].x == -1);
+    REQUIRE(vec[1].x == 0);
+    REQUIRE(vec[5].x == 100);
+    REQUIRE(vec[6].x == 4);
+    REQUIRE(vec[9].x == 7);
+
+    vec.erase(0);
+    vec.erase(4);
+    REQUIRE(vec.size() == 8);
+    for (int i = 0; i < 8; i++) {
+        REQUIRE(vec[i].x == i);
+        REQUIRE(vec[i].y == i * 0.5f);
+    }
+
+    dsa::Vector<Point> copy(vec);
+    REQUIRE(copy[7].x == 7);
+}
+
+// owns heap memory but never points into itself, so it may be relocated
+struct OwnedInt {
+    int* ptr;
+    OwnedInt(int v) : ptr(new int(v)) {}
+    OwnedInt(const OwnedInt& other) : ptr(new int(*other.ptr)) {}
+    OwnedInt(OwnedInt&& other) noexcept : ptr(other.ptr) { other.ptr = nullptr; }
+    OwnedInt& operator=(OwnedInt other) { std::swap(ptr, other.ptr); return *this; }
+    ~OwnedInt() { delete ptr; }
+};
+
+template <>
+struct dsa::is_relocatable<OwnedInt> : std::true_type {};
+
+TEST_CASE("Relocatable elements grow in place", "[vector]") {
+    STATIC_REQUIRE(dsa::is_relocatable_v<int>);
+    STATIC_REQUIRE(dsa::is_relocatable_v<OwnedInt>);
+
+    SECTION("Opt-in relocatable type") {
+        dsa::Vector<OwnedInt> vec;
+        for (int i = 0; i < 1000; i++) {
+            vec.push_back(OwnedInt(i));
+        }
+        vec.insert(0, OwnedInt(-1));
+        vec.erase(0);
+        for (int i = 0; i < 1000; i++) {
+            REQUIRE(*vec[i].ptr == i);
+        }
+        while (vec.size() > 3) {
+            vec.pop_back();
+        }
+        vec.shrink_to_fit();
+        REQUIRE(vec.capacity() == 3);
+        REQUIRE(*vec.back().ptr == 2);
+    }
+
+    SECTION("Growth across the mremap threshold") {
+        dsa::Vector<int> vec;
+        int n = static_cast<int>(DSA_MREMAP_THRESHOLD / sizeof(int)) + 1000;
+        for (int i = 0; i < n; i++) {
+            vec.push_back(i);
+        }
+        REQUIRE(vec[0] == 0);
+        REQUIRE(vec[n / 2] == n / 2);
+        REQUIRE(vec.back() == n - 1);
+        while (vec.size() > 10) {
+            vec.pop_back();
+        }
+        REQUIRE(vec.capacity() < static_cast<std::size_t>(n));
+        REQUIRE(vec[9] == 9);
+    }
+
+    SECTION("Reallocating to zero capacity releases the buffer") {
+        dsa::Vector<int> vec;
+        vec.push_back(1);
+        vec.pop_back();
+        vec.reallocate(0);
+        REQUIRE(vec.capacity() == 0);
+        REQUIRE(vec.data() == nullptr);
+        vec.reallocate(0);
+        vec.push_back(2);
+        REQUIRE(vec.back() == 2);
+    }
+}
+
+TEST_CASE("Contiguous iterators work with the standard library", "[vector][iterator]") {
+    using It = dsa::Vector<int>::iterator;
+    using CIt = dsa::Vector<int>::const_iterator;
+    STATIC_REQUIRE(std::contiguous_iterator<It>);
+    STATIC_REQUIRE(std::contiguous_iterator<CIt>);
+    STATIC_REQUIRE(std::ranges::contiguous_range<dsa::Vector<int>>);
+    STATIC_REQUIRE(std::is_convertible_v<It, CIt>);
+    STATIC_REQUIRE_FALSE(std::is_convertible_v<CIt, It>);
+
+    dsa::Vector<int> vec;
+    for (int i : {5, 3, 9, 1, 7}) {
+        vec.push_back(i);
+    }
+
+    SECTION("Arithmetic, ordering and data()") {
+        auto it = vec.begin();
+        REQUIRE(vec.end() - vec.begin() == 5);
+        REQUIRE(it[2] == 9);
+        REQUIRE(*(it + 4) == 7);
+        REQUIRE(*(4 + it) == 7);
+        REQUIRE(it < it + 1);
+        REQUIRE(&*it == vec.data());
+        REQUIRE(std::to_address(vec.end()) == vec.data() + vec.size());
+        CIt cit = it;
+        REQUIRE(cit == vec.cbegin());
+    }
+
+    SECTION("Sorting and searching") {
+        std::sort(vec.begin(), vec.end());
+        REQUIRE(std::is_sorted(vec.begin(), vec.end()));
+        REQUIRE(*std::lower_bound(vec.begin(), vec.end(), 6) == 7);
+        std::ranges::sort(vec, std::greater<>());
+        REQUIRE(vec.front() == 9);
+        REQUIRE(vec.back() == 1);
+    }
+
+    SECTION("Copying between vectors") {
+        dsa::Vector<int> out;
+        out.reserve(vec.size());
+        for (std::size_t i = 0; i < vec.size(); i++) {
+            out.push_back(0);
+        }
+        std::ranges::copy(vec, out.begin());
+        REQUIRE(std::equal(vec.begin(), vec.end(), out.begin(), out.end()));
+    }
+
+    SECTION("Iterator insert and erase return valid positions") {
+        vec.shrink_to_fit();
+        auto it = vec.insert(vec.begin() + 1, 4);  // reallocates
+        REQUIRE(*it == 4);
+        REQUIRE(it - vec.begin() == 1);
+        it = vec.erase(it);
+        REQUIRE(*it == 3);
+        REQUIRE(vec.size() == 5);
+    }
+}
+
+TEST_CASE("SmallVector keeps short vectors inline", "[smallvector]") {
+    SECTION("No heap storage up to N elements") {
+        dsa::SmallVector<int, 4> sv;
+        REQUIRE(sv.capacity() == 4);
+        for (int i = 0; i < 4; i++) {
+            sv.push_back(i);
+        }
+        REQUIRE(sv.is_small());
+        REQUIRE(sv.capacity() == 4);
+        sv.push_back(4);  // spills
+        REQUIRE_FALSE(sv.is_small());
+        REQUIRE(sv.capacity() == 8);
+        for (int i = 0; i < 5; i++) {
+            REQUIRE(sv[i] == i);
+        }
+    }
+
+    SECTION("Same API as Vector") {
+        dsa::SmallVector<std::string, 2> sv;
+        sv.push_back("b");
+        sv.insert(0, "a");
+        sv.emplace_back(3, 'c');
+        REQUIRE(sv.size() == 3);
+        REQUIRE(sv[2] == "ccc");
+        sv.erase(sv.begin());
+        REQUIRE(sv.front() == "b");
+        std::sort(sv.begin(), sv.end(), std::greater<>());
+        REQUIRE(sv.front() == "ccc");
+        // not a Vector: the base is private
+        STATIC_REQUIRE_FALSE(std::is_convertible_v<dsa::SmallVector<std::string, 2>&,
+                                                   dsa::Vector<std::string>&>);
+    }
+
+    SECTION("Shrinking never drops below the inline buffer") {
+        dsa::SmallVector<int, 8> sv;
+        sv.push_back(1);
+        sv.pop_back();
+        sv.shrink_to_fit();
+        REQUIRE(sv.is_small());
+        REQUIRE(sv.capacity() == 8);
+    }
+
+    SECTION("Copy and move, inline and spilled") {
+        dsa::SmallVector<std::string, 2> small_src;
+        small_src.push_back("x");
+        dsa::SmallVector<std::string, 2> big_src;
+        for (int i = 0; i < 5; i++) {
+            big_src.push_back(std::string(20, static_cast<char>('a' + i)));
+        }
+
+        dsa::SmallVector<std::string, 2> copy(small_src);
+        REQUIRE(copy.is_small());
+        REQUIRE(copy[0] == "x");
+        copy = big_src;
+        REQUIRE(copy.size() == 5);
+        REQUIRE(copy[4] == std::string(20, 'e'));
+
+        dsa::SmallVector<std::string, 2> moved(std::move(small_src));
+        REQUIRE(moved.is_small());
+        REQUIRE(moved[0] == "x");
+        REQUIRE(small_src.empty()); // NOLINT: intentional use after move
+
+        const std::string* heap = big_src.data();
+        dsa::SmallVector<std::string, 2> stolen(std::move(big_src));
+        REQUIRE(stolen.data() == heap);
+        REQUIRE(big_src.empty()); // NOLINT: intentional use after move
+        REQUIRE(big_src.is_small());
+        big_src.push_back("reuse");
+        REQUIRE(big_src.is_small());
+
+        moved = std::move(stolen);
+        REQUIRE(moved.size() == 5);
+        REQUIRE(moved.data() == heap);
+        REQUIRE(stolen.is_small());
+    }
+
+    SECTION("Moves are noexcept exactly when they cannot allocate") {
+        using Strings = dsa::SmallVector<std::string, 2>;
+        STATIC_REQUIRE(std::is_nothrow_move_constructible_v<Strings>);
+        STATIC_REQUIRE(std::is_nothrow_move_assignable_v<Strings>);
+        struct ThrowingMove {
+            ThrowingMove() = default;
+            ThrowingMove(const ThrowingMove&) = default;
+            ThrowingMove(ThrowingMove&&) noexcept(false) {}
+        };
+        STATIC_REQUIRE_FALSE(std::is_nothrow_move_constructible_v<dsa::SmallVector<ThrowingMove, 2>>);
+        STATIC_REQUIRE_FALSE(std::is_nothrow_move_assignable_v<
+                             dsa::SmallVector<int, 2, dsa::DoublingGrowth, std::size_t,
+                                              std::pmr::polymorphic_allocator<int>>>);
+
+        // a spilled target goes back to its inline buffer for an inline source
+        Strings target{"a", "b", "c"};
+        REQUIRE_FALSE(target.is_small());
+        Strings source{"x"};
+        target = std::move(source);
+        REQUIRE(target.is_small());
+        REQUIRE(target.size() == 1);
+        REQUIRE(target[0] == "x");
+    }
+}
+
+// memory resource that counts what it hands out
+class CountingResource : public std::pmr::memory_resource {
+public:
+    int allocations{0};
+    int live{0};
+
+private:
+    void* do_allocate(std::size_t bytes, std::size_t align) override {
+        allocations++;
+        live++;
+        return std::pmr::new_delete_resource()->allocate(bytes, align);
+    }
+    void do_deallocate(void* p, std::size_t bytes, std::size_t align) override {
+        live--;
+        std::pmr::new_delete_resource()->deallocate(p, bytes, align);
+    }
+    bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override {
+        return this == &other;
+    }
+};
+
+TEST_CASE("Allocator-aware Vector", "[vector][allocator]") {
+    CountingResource res;
+
+    SECTION("Storage comes from the memory resource") {
+        {
+            dsa::pmr::Vector<int> vec(&res);
+            for (int i = 0; i < 100; i++) {
+                vec.push_back(i);
+            }
+            REQUIRE(vec.get_allocator().resource() == &res);
+            REQUIRE(res.allocations > 0);
+            REQUIRE(vec[99] == 99);
+        }
+        REQUIRE(res.live == 0);
+    }
+
+    SECTION("Nested vectors inherit the resource") {
+        dsa::pmr::Vector<dsa::pmr::Vector<int>> rows(&res);
+        rows.emplace_back().push_back(1);
+        dsa::pmr::Vector<int> outside;  // default resource
+        outside.push_back(2);
+        rows.push_back(outside);
+        REQUIRE(rows[0].get_allocator().resource() == &res);
+        REQUIRE(rows[1].get_allocator().resource() == &res);
+        REQUIRE(rows[1][0] == 2);
+    }
+
+    SECTION("Moving between resources moves the elements") {
+        CountingResource other;
+        dsa::pmr::Vector<std::pmr::string> a(&res);
+        a.emplace_back("a long string that does not fit inline");
+        dsa::pmr::Vector<std::pmr::string> b(&other);
+        b = std::move(a);
+        REQUIRE(b.get_allocator().resource() == &other);
+        REQUIRE(b[0] == "a long string that does not fit inline");
+        REQUIRE(b[0].get_allocator().resource() == &other);
+
+        dsa::pmr::Vector<std::pmr::string> c(std::move(b));
+        REQUIRE(c.get_allocator().resource() == &other);
+        REQUIRE(c.size() == 1);
+    }
+
+    SECTION("Monotonic arena released in one shot") {
+        std::pmr::monotonic_buffer_resource arena(&res);
+        {
+            dsa::pmr::Vector<int> vec(&arena);
+            for (int i = 0; i < 1000; i++) {
+                vec.push_back(i);
+            }
+            REQUIRE(vec.back() == 999);
+        }
+        REQUIRE(res.live > 0);  // the arena still holds its blocks
+        arena.release();
+        REQUIRE(res.live == 0);
+    }
+
+    SECTION("Matrix allocates from the given resource") {
+        {
+            dsa::Matrix m(4, 4, &res);
+            m(3, 3) = 9;
+            dsa::Matrix sum = m + m;
+            REQUIRE(sum(3, 3) == 18);
+            REQUIRE(res.allocations == 2);  // one buffer per matrix
+        }
+        REQUIRE(res.live == 0);
+    }
+
+    SECTION("SmallVector takes its heap storage from the allocator") {
+        CountingResource res;
+        using Arena = dsa::SmallVector<int, 2, dsa::DoublingGrowth, std::size_t,
+                                       std::pmr::polymorphic_allocator<int>>;
+        Arena sv(&res);
+        sv.push_back(1);
+        sv.push_back(2);
+        REQUIRE(res.allocations == 0);
+        sv.push_back(3);
+        REQUIRE(res.allocations == 1);
+        REQUIRE(sv.get_allocator().resource() == &res);
+        Arena moved(std::move(sv));
+        REQUIRE(moved.get_allocator().resource() == &res);
+        REQUIRE(moved.size() == 3);
+        REQUIRE(res.allocations == 1);
+        REQUIRE(sv.is_small());
+    }
+}
+
+TEMPLATE_LIST_TEST_CASE("Matrix flat storage", "[matrix]", MatrixTypes) {
+    dsa::Matrix<TestType> a(3, 5);
+    dsa::Matrix<TestType> b(3, 5);
+    for (int i = 0; i < 3; i++) {
+        for (int j = 0; j < 5; j++) {
+            a(i, j) = static_cast<TestType>(i * 5 + j);
+            b(i, j) = static_cast<TestType>(10 * i - j);
+        }
+    }
+    dsa::Matrix<TestType> sum = a + b;
+    for (int i = 0; i < 3; i++) {
+        for (int j = 0; j < 5; j++) {
+            REQUIRE(sum(i, j) == static_cast<TestType>(i * 5 + j + 10 * i - j));
+        }
+    }
+    REQUIRE_THROWS_AS(a.at(3, 0), std::out_of_range);
+    REQUIRE_THROWS_AS(a.at(0, 5), std::out_of_range);
+    REQUIRE_THROWS_AS(a.at(-1, 0), std::out_of_range);
+}
+
+TEMPLATE_LIST_TEST_CASE("Matrix product and gemm", "[matrix][gemm]", MatrixTypes) {
+    // small integer entries keep every product exact for all element types
+    auto fill = [](dsa::Matrix<TestType>& m, int r, int c, int seed) {
+        for (int i = 0; i < r; i++) {
+            for (int j = 0; j < c; j++) {
+                m(i, j) = static_cast<TestType>((i * 7 + j * 3 + seed) % 3 - 1);
+            }
+        }
+    };
+    auto naive = [](dsa::Matrix<TestType>& a, dsa::Matrix<TestType>& b, int k, int i, int j) {
+        long long sum = 0;
+        for (int p = 0; p < k; p++) {
+            sum += static_cast<long long>(a(i, p)) * static_cast<long long>(b(p, j));
+        }
+        return sum;
+    };
+
+    // shapes below, at and past the micro-tile, and k past one packed panel
+    const int shapes[][3] = {{1, 1, 1}, {7, 13, 5}, {12, 32, 16}, {37, 29, 41}, {50, 70, 300}};
+    for (auto& shape : shapes) {
+        int m = shape[0], n = shape[1], k = shape[2];
+        dsa::Matrix<TestType> a(m, k);
+        dsa::Matrix<TestType> b(k, n);
+        fill(a, m, k, 1);
+        fill(b, k, n, 2);
+
+        dsa::Matrix<TestType> prod = a * b;
+        dsa::Matrix<TestType> c(m, n);
+        fill(c, m, n, 0);
+        dsa::gemm(TestType(2), a, b, TestType(3), c);
+        dsa::Matrix<TestType> c0(m, n);
+        fill(c0, m, n, 0);
+        for (int i = 0; i < m; i++) {
+            for (int j = 0; j < n; j++) {
+                long long expect = naive(a, b, k, i, j);
+                REQUIRE(prod(i, j) == static_cast<TestType>(expect));
+                REQUIRE(c(i, j) == static_cast<TestType>(2 * expect + 3 * static_cast<long long>(c0(i, j))));
+            }
+        }
+    }
+
+    SECTION("beta == 0 overwrites C") {
+        dsa::Matrix<TestType> a(2, 2);
+        dsa::Matrix<TestType> b(2, 2);
+        dsa::Matrix<TestType> c(2, 2);
+        a(0, 0) = 1; a(1, 1) = 1;
+        b(0, 1) = 2; b(1, 0) = 3;
+        c(0, 0) = 100; c(1, 1) = 100;
+        dsa::gemm(TestType(1), a, b, TestType(0), c);
+        REQUIRE(c(0, 0) == 0);
+        REQUIRE(c(0, 1) == 2);
+        REQUIRE(c(1, 0) == 3);
+        REQUIRE(c(1, 1) == 0);
+    }
+
+    SECTION("mismatched dimensions throw") {
+        dsa::Matrix<TestType> a(2, 3);
+        dsa::Matrix<TestType> b(2, 3);
+        dsa::Matrix<TestType> c(2, 2);
+        REQUIRE_THROWS_AS(a * b, std::out_of_range);
+        REQUIRE_THROWS_AS(dsa::gemm(TestType(1), a, b, TestType(0), c), std::out_of_range);
+        dsa::Matrix<TestType> bt(3, 2);
+        dsa::Matrix<TestType> wrong(3, 2);
+        REQUIRE_THROWS_AS(dsa::gemm(TestType(1), a, bt, TestType(0), wrong), std::out_of_range);
+    }
+}
+
+TEST_CASE("ThreadPool parallel_for", "[threadpool]") {
+    dsa::ThreadPool pool(4);
+    REQUIRE(pool.size() == 4);
+
+    SECTION("every index is visited exactly once") {
+        std::vector<std::atomic<int>> hits(10007);
+        std::atomic<std::size_t> largest{0};
+        pool.parallel_for(hits.size(), 16, [&](std::size_t begin, std::size_t end) {
+            // Catch assertions are not thread-safe; check afterwards
+            std::size_t len = end - begin;
+            std::size_t seen = largest.load();
+            while (len > seen && !largest.compare_exchange_weak(seen, len)) {}
+            for (std::size_t i = begin; i < end; i++) {
+                hits[i].fetch_add(1);
+            }
+        });
+        REQUIRE(largest.load() <= 16);
+        for (auto& h : hits) {
+            REQUIRE(h.load() == 1);
+        }
+    }
+
+    SECTION("nested loops run on the same pool") {
+        std::atomic<long> sum{0};
+        pool.parallel_for(8, 1, [&](std::size_t begin, std::size_t end) {
+            for (std::size_t i = begin; i < end; i++) {
+                pool.parallel_for(100, 10, [&](std::size_t b, std::size_t e) {
+                    sum.fetch_add(static_cast<long>(e - b));
+                });
+            }
+        });
+        REQUIRE(sum.load() == 800);
+    }
+
+    SECTION("exceptions reach the caller") {
+        REQUIRE_THROWS_AS(pool.parallel_for(1000, 10, [](std::size_t begin, std::size_t) {
+            if (begin >= 500) {
+                throw std::runtime_error("boom");
+            }
+        }), std::runtime_error);
+    }
+
+    SECTION("a single thread calls the body once") {
+        dsa::ThreadPool single(1);
+        int calls = 0;
+        std::size_t first = 1, last = 0;
+        single.parallel_for(1000, 10, [&](std::size_t begin, std::size_t end) {
+            calls++;
+            first = begin;
+            last = end;
+        });
+        REQUIRE(calls == 1);
+        REQUIRE(first == 0);
+        REQUIRE(last == 1000);
+    }
+}
+
+TEMPLATE_LIST_TEST_CASE("Matrix operations on the thread pool", "[matrix][threadpool]", MatrixTypes) {
+    // small grain so even these matrices are split across threads
+    dsa::parallel::set_threads(4);
+    dsa::parallel::set_grain(7);
+
+    const int r = 45, c = 70;
+    dsa::Matrix<TestType> a(r, c);
+    dsa::Matrix<TestType> b(r, c);
+    for (int i = 0; i < r; i++) {
+        for (int j = 0; j < c; j++) {
+            a(i, j) = static_cast<TestType>((i + 2 * j) % 5);
+            b(i, j) = static_cast<TestType>((3 * i + j) % 4);
+        }
+    }
+
+    dsa::Matrix<TestType> sum = a + b;
+    dsa::Matrix<TestType> diff = a - b;
+    dsa::Matrix<TestType> scaled = a * TestType(3);
+    dsa::Matrix<TestType> scaled_left = TestType(2) * b;
+    dsa::Matrix<TestType> t = a.transpose();
+    for (int i = 0; i < r; i++) {
+        for (int j = 0; j < c; j++) {
+            REQUIRE(sum(i, j) == static_cast<TestType>(a(i, j) + b(i, j)));
+            REQUIRE(diff(i, j) == static_cast<TestType>(a(i, j) - b(i, j)));
+            REQUIRE(scaled(i, j) == static_cast<TestType>(a(i, j) * 3));
+            REQUIRE(scaled_left(i, j) == static_cast<TestType>(2 * b(i, j)));
+            REQUIRE(t(j, i) == a(i, j));
+        }
+    }
+    REQUIRE_THROWS_AS(t.at(c, 0), std::out_of_range);
+    REQUIRE_THROWS_AS(a - t, std::out_of_range);
+
+    // big enough for tiled parallel gemm
+    const int m = 100, n = 300, k = 20;
+    dsa::Matrix<TestType> x(m, k);
+    dsa::Matrix<TestType> y(k, n);
+    for (int i = 0; i < m; i++) {
+        for (int p = 0; p < k; p++) {
+            x(i, p) = static_cast<TestType>((i + p) % 3 - 1);
+        }
+    }
+    for (int p = 0; p < k; p++) {
+        for (int j = 0; j < n; j++) {
+            y(p, j) = static_cast<TestType>((p * j) % 3 - 1);
+        }
+    }
+    dsa::Matrix<TestType> prod = x * y;
+    for (int i = 0; i < m; i++) {
+        for (int j = 0; j < n; j++) {
+            long long expect = 0;
+            for (int p = 0; p < k; p++) {
+                expect += static_cast<long long>(x(i, p)) * static_cast<long long>(y(p, j));
+            }
+            REQUIRE(prod(i, j) == static_cast<TestType>(expect));
+        }
+    }
+
+    dsa::parallel::set_grain(std::size_t(1) << 16);
+    dsa::parallel::set_threads(0);
+}
+
+TEMPLATE_LIST_TEST_CASE("Matrix expressions evaluate in one fused pass", "[matrix][expr]", MatrixTypes) {
+    CountingResource res;
+    const int r = 6, c = 9;
+    dsa::Matrix<TestType> a(r, c, &res);
+    dsa::Matrix<TestType> b(r, c, &res);
+    dsa::Matrix<TestType> cm(r, c, &res);
+    dsa::Matrix<TestType> d(r, c, &res);
+    for (int i = 0; i < r; i++) {
+        for (int j = 0; j < c; j++) {
+            a(i, j) = static_cast<TestType>(i + j);
+            b(i, j) = static_cast<TestType>(i - j);
+            cm(i, j) = static_cast<TestType>(j % 3);
+            d(i, j) = static_cast<TestType>(1);
+        }
+    }
+    REQUIRE(res.allocations == 4);
+
+    dsa::Matrix<TestType> sum = a + b + cm + d;
+    REQUIRE(res.allocations == 5);  // the result only, no temporaries
+
+    dsa::Matrix<TestType> mixed = (a - b) * TestType(2) + TestType(3) * cm - d;
+    for (int i = 0; i < r; i++) {
+        for (int j = 0; j < c; j++) {
+            REQUIRE(sum(i, j) == static_cast<TestType>(a(i, j) + b(i, j) + cm(i, j) + d(i, j)));
+            REQUIRE(mixed(i, j) == static_cast<TestType>((a(i, j) - b(i, j)) * 2 + 3 * cm(i, j) - d(i, j)));
+        }
+    }
+
+    SECTION("assigning to a matching matrix reuses its buffer") {
+        int before = res.allocations;
+        sum = a + d;
+        REQUIRE(res.allocations == before);
+        REQUIRE(sum(2, 3) == static_cast<TestType>(a(2, 3) + 1));
+    }
+
+    SECTION("a matrix may appear on both sides") {
+        a = a + a + b;
+        REQUIRE(a(2, 3) == static_cast<TestType>(2 * (2 + 3) + (2 - 3)));
+    }
+
+    SECTION("assigning a different shape reallocates") {
+        dsa::Matrix<TestType> small(1, 1, &res);
+        small = a - b;
+        REQUIRE_NOTHROW(small(r - 1, c - 1));
+        REQUIRE(small(r - 1, c - 1) == static_cast<TestType>(2 * (c - 1)));
+    }
+
+    SECTION("shape mismatches throw when the expression is built") {
+        dsa::Matrix<TestType> other(c, r);
+        REQUIRE_THROWS_AS(a + b + other, std::out_of_range);
+        REQUIRE_THROWS_AS(a - other, std::out_of_range);
+    }
+
+    SECTION("class template argument deduction sees through expressions") {
+        dsa::Matrix deduced = a + b;
+        STATIC_REQUIRE(std::is_same_v<decltype(deduced), dsa::Matrix<TestType>>);
+    }
+
+    SECTION("products and transpose() take expressions") {
+        dsa::Matrix<TestType> sum_ab = a + b;
+        dsa::Matrix<TestType> cols(c, 4, &res);
+        for (int i = 0; i < c; i++) {
+            for (int j = 0; j < 4; j++) {
+                cols(i, j) = static_cast<TestType>((i + 2 * j) % 5);
+            }
+        }
+        dsa::Matrix<TestType> left = (a + b) * cols;
+        dsa::Matrix<TestType> expected = sum_ab * cols;
+        dsa::Matrix<TestType> t = (a + b).transpose();
+        dsa::Matrix<TestType> right = t * (a - b);
+        dsa::Matrix<TestType> both = (a + b).transpose() * (a - b);
+        dsa::Matrix<TestType> diff = a - b;
+        dsa::Matrix<TestType> right_expected = t * diff;
+        REQUIRE(t.rows() == c);
+        REQUIRE(t.cols() == r);
+        for (int i = 0; i < r; i++) {
+            for (int j = 0; j < c; j++) {
+                REQUIRE(t(j, i) == sum_ab(i, j));
+            }
+            for (int j = 0; j < 4; j++) {
+                REQUIRE(left(i, j) == expected(i, j));
+            }
+        }
+        for (int i = 0; i < c; i++) {
+            for (int j = 0; j < c; j++) {
+                REQUIRE(right(i, j) == right_expected(i, j));
+                REQUIRE(both(i, j) == right_expected(i, j));
+            }
+        }
+        REQUIRE_THROWS_AS((a + b) * a, std::out_of_range);
+        REQUIRE_THROWS_AS((a + b) * (a - b), std::out_of_range);
+    }
+}
+
+TEMPLATE_LIST_TEST_CASE("Matrix compound assignment works in place", "[matrix][expr]", MatrixTypes) {
+    CountingResource res;
+    const int r = 5, c = 37;  // 185 elements: whole blocks of 16 plus a tail
+    dsa::Matrix<TestType> m(r, c, &res);
+    dsa::Matrix<TestType> x(r, c, &res);
+    for (int i = 0; i < r; i++) {
+        for (int j = 0; j < c; j++) {
+            m(i, j) = static_cast<TestType>((i + j) % 7);
+            x(i, j) = static_cast<TestType>(j % 3 + 1);
+        }
+    }
+    int before = res.allocations;
+
+    m += x;
+    REQUIRE(m(4, 36) == static_cast<TestType>((4 + 36) % 7 + 36 % 3 + 1));
+    m -= x;
+    REQUIRE(m(4, 36) == static_cast<TestType>((4 + 36) % 7));
+    m += x * TestType(2) + x;  // a fused expression on the right
+    REQUIRE(m(1, 2) == static_cast<TestType>(3 + 3 * 3));
+    m -= x + x + x;
+    REQUIRE(m(1, 2) == static_cast<TestType>(3));
+    m.multiply_elementwise(x);
+    REQUIRE(m(1, 2) == static_cast<TestType>(3 * 3));
+    m *= TestType(4);
+    REQUIRE(m(1, 2) == static_cast<TestType>(36));
+    m /= TestType(2);
+    REQUIRE(m(1, 2) == static_cast<TestType>(18));
+    m += m;
+    REQUIRE(m(1, 2) == static_cast<TestType>(36));
+    for (int i = 0; i < r; i++) {
+        for (int j = 0; j < c; j++) {
+            REQUIRE(m(i, j) == static_cast<TestType>((i + j) % 7 * (j % 3 + 1) * 4));
+        }
+    }
+    REQUIRE(res.allocations == before);
+
+    dsa::Matrix<TestType> other(c, r);
+    REQUIRE_THROWS_AS(m += other, std::out_of_range);
+    REQUIRE_THROWS_AS(m -= other, std::out_of_range);
+    REQUIRE_THROWS_AS(m.multiply_elementwise(other), std::out_of_range);
+    if constexpr (std::is_integral_v<TestType>) {
+        REQUIRE_THROWS_AS(m /= TestType(0), std::invalid_argument);
+    }
+}
+
+TEMPLATE_LIST_TEST_CASE("Matrix element access paths", "[matrix]", MatrixTypes) {
+    dsa::Matrix<TestType> m(3, 4);
+    REQUIRE(m.rows() == 3);
+    REQUIRE(m.cols() == 4);
+    REQUIRE(m.stride() == 4);
+
+    for (int i = 0; i < m.rows(); i++) {
+        std::span<TestType> row = m.row(i);
+        REQUIRE(row.size() == 4);
+        for (std::size_t j = 0; j < row.size(); j++) {
+            row[j] = static_cast<TestType>(i * 4 + static_cast<int>(j));
+        }
+    }
+    REQUIRE(m(2, 3) == 11);
+    REQUIRE(m.at(1, 2) == 6);
+    REQUIRE(m.unchecked(1, 3) == 7);
+    REQUIRE(m.data() + 2 * m.stride() == &m(2, 0));
+
+    const dsa::Matrix<TestType>& cm = m;
+    std::span<const TestType> last = cm.row(2);
+    REQUIRE(std::accumulate(last.begin(), last.end(), 0) == 8 + 9 + 10 + 11);
+    REQUIRE(cm.at(0, 1) == 1);
+    REQUIRE(cm.unchecked(0, 2) == 2);
+    REQUIRE(cm.data()[5] == 5);
+
+    m.unchecked(0, 0) = 42;
+    REQUIRE(m.at(0, 0) == 42);
+
+    REQUIRE_THROWS_AS(m.at(3, 0), std::out_of_range);
+    REQUIRE_THROWS_AS(m.at(0, -1), std::out_of_range);
+    REQUIRE_THROWS_AS(cm.at(-1, 0), std::out_of_range);
+#if DSA_MATRIX_CHECKED
+    REQUIRE_THROWS_AS(m(3, 0), std::out_of_range);
+    REQUIRE_THROWS_AS(m(0, 4), std::out_of_range);
+    REQUIRE_THROWS_AS(m.row(3), std::out_of_range);
+    REQUIRE_THROWS_AS(cm.row(-1), std::out_of_range);
+#endif
+}
+
+TEMPLATE_LIST_TEST_CASE("Const matrices can be read and combined", "[matrix]", MatrixTypes) {
+    dsa::Matrix<TestType> m(3, 3);
+    for (int i = 0; i < 3; i++) {
+        for (int j = 0; j < 3; j++) {
+            m(i, j) = static_cast<TestType>(i == j ? 2 : (i + j) % 2);
+        }
+    }
+    const dsa::Matrix<TestType>& a = m;
+    const dsa::Matrix<TestType> b = m;
+
+    REQUIRE(a(1, 1) == 2);
+    REQUIRE(b(0, 1) == 1);
+    STATIC_REQUIRE(std::is_same_v<decltype(a(0, 0)), const TestType&>);
+
+    dsa::Matrix<TestType> sum = a + b;
+    dsa::Matrix<TestType> diff = a - b;
+    dsa::Matrix<TestType> scaled = a * TestType(3);
+    dsa::Matrix<TestType> prod = a * b;
+    dsa::Matrix<TestType> t = a.transpose();
+    REQUIRE(sum(2, 2) == 4);
+    REQUIRE(diff(0, 1) == 0);
+    REQUIRE(scaled(1, 1) == 6);
+    REQUIRE(prod(0, 0) == static_cast<TestType>(2 * 2 + 1 * 1 + 0 * 0));
+    REQUIRE(t(1, 0) == a(0, 1));
+
+    dsa::Matrix<TestType> c(3, 3);
+    dsa::gemm(TestType(1), a, b, TestType(0), c);
+    REQUIRE(c(0, 0) == prod(0, 0));
+#if DSA_MATRIX_CHECKED
+    REQUIRE_THROWS_AS(a(3, 0), std::out_of_range);
+#endif
+}
+
+TEST_CASE("Concurrent readers share one const Matrix", "[matrix][threadpool]") {
+    dsa::parallel::set_threads(4);
+    dsa::parallel::set_grain(64);
+
+    const int n = 96;
+    dsa::Matrix<double> model(n, n);
+    for (int i = 0; i < n; i++) {
+        for (int j = 0; j < n; j++) {
+            model(i, j) = double((i * 31 + j * 17) % 11) - 5.0;
+        }
+    }
+    const dsa::Matrix<double>& shared = model;
+    dsa::Matrix<double> expect_sum = shared + shared;
+    dsa::Matrix<double> expect_prod = shared * shared;
+    dsa::Matrix<double> expect_t = shared.transpose();
+
+    const int readers = 6;
+    std::vector<int> mismatches(readers, 0);
+    std::vector<std::thread> threads;
+    for (int r = 0; r < readers; r++) {
+        threads.emplace_back([&, r] {
+            for (int rep = 0; rep < 5; rep++) {
+                dsa::Matrix<double> sum = shared + shared;
+                dsa::Matrix<double> prod = shared * shared;
+                dsa::Matrix<double> t = shared.transpose();
+                for (int i = 0; i < n; i++) {
+                    std::span<const double> row = shared.row(i);
+                    for (int j = 0; j < n; j++) {
+                        mismatches[r] += sum(i, j) != expect_sum(i, j);
+                        mismatches[r] += prod(i, j) != expect_prod(i, j);
+                        mismatches[r] += t(i, j) != expect_t(i, j);
+                        mismatches[r] += row[j] != shared(i, j);
+                    }
+                }
+            }
+        });
+    }
+    for (std::thread& th : threads) {
+        th.join();
+    }
+    for (int r = 0; r < readers; r++) {
+        REQUIRE(mismatches[r] == 0);
+    }
+
+    dsa::parallel::set_grain(std::size_t(1) << 16);
+    dsa::parallel::set_threads(0);
+}
+
+TEMPLATE_LIST_TEST_CASE("Matrix transpose, blocked and in place", "[matrix][transpose]", MatrixTypes) {
+    // shapes below, at and across the 8x8 tiles, the 64x64 leaves
+    // (detail::transpose_leaf) and the 64-row bands
+    const int shapes[][2] = {{1, 1}, {1, 9}, {9, 1}, {8, 8}, {7, 13}, {33, 65}, {100, 37},
+                             {63, 63}, {64, 64}, {65, 65}, {129, 129}, {130, 130},
+                             {63, 65}, {65, 64}, {64, 129}, {129, 63}};
+    dsa::parallel::set_threads(3);
+    dsa::parallel::set_grain(1);
+    for (auto& shape : shapes) {
+        int r = shape[0], c = shape[1];
+        dsa::Matrix<TestType> m(r, c);
+        for (int i = 0; i < r; i++) {
+            for (int j = 0; j < c; j++) {
+                m(i, j) = static_cast<TestType>((i * 7 + j) % 101);
+            }
+        }
+        dsa::Matrix<TestType> t = m.transpose();
+        REQUIRE(t.rows() == c);
+        REQUIRE(t.cols() == r);
+        dsa::Matrix<TestType> in_place = m;
+        in_place.transpose_in_place();
+        REQUIRE(in_place.rows() == c);
+        REQUIRE(in_place.cols() == r);
+        for (int i = 0; i < r; i++) {
+            for (int j = 0; j < c; j++) {
+                REQUIRE(t(j, i) == m(i, j));
+                REQUIRE(in_place(j, i) == m(i, j));
+            }
+        }
+        in_place.transpose_in_place();
+        for (int i = 0; i < r; i++) {
+            for (int j = 0; j < c; j++) {
+                REQUIRE(in_place(i, j) == m(i, j));
+            }
+        }
+    }
+    dsa::parallel::set_grain(std::size_t(1) << 16);
+    dsa::parallel::set_threads(0);
+
+    SECTION("square matrices transpose without allocating") {
+        CountingResource res;
+        dsa::Matrix<TestType> sq(40, 40, &res);
+        sq(3, 17) = 5;
+        int before = res.allocations;
+        sq.transpose_in_place();
+        REQUIRE(res.allocations == before);
+        REQUIRE(sq(17, 3) == 5);
+        REQUIRE(sq(3, 17) == 0);
+    }
+}
+
+TEMPLATE_TEST_CASE("SparseMatrix in CSR and CSC", "[sparse]", int, double) {
+    using Sparse = dsa::SparseMatrix<TestType>;
+    using dsa::SparseLayout;
+    // about one entry in five, a few duplicates, in scrambled order
+    auto random_triplets = [](int r, int c, unsigned seed) {
+        dsa::Vector<dsa::Triplet<TestType>> t;
+        unsigned x = seed;
+        int count = r * c / 5 + 3;
+        for (int k = 0; k < count; k++) {
+            x = x * 1103515245u + 12345u;
+            int i = static_cast<int>((x >> 8) % static_cast<unsigned>(r));
+            x = x * 1103515245u + 12345u;
+            int j = static_cast<int>((x >> 8) % static_cast<unsigned>(c));
+            t.push_back({i, j, static_cast<TestType>(static_cast<int>(x >> 20) % 9 - 4)});
+        }
+        return t;
+    };
+    auto dense_of = [](int r, int c, const dsa::Vector<dsa::Triplet<TestType>>& t) {
+        dsa::Matrix<TestType> m(r, c);
+        for (const auto& e : t) {
+            m(e.row, e.col) += e.value;
+        }
+        return m;
+    };
+    auto equal = [](const dsa::Matrix<TestType>& a, const dsa::Matrix<TestType>& b) {
+        if (a.rows() != b.rows() || a.cols() != b.cols()) {
+            return false;
+        }
+        for (int i = 0; i < a.rows(); i++) {
+            for (int j = 0; j < a.cols(); j++) {
+                if (a(i, j) != b(i, j)) {
+                    return false;
+                }
+            }
+        }
+        return true;
+    };
+
+    SECTION("triplets are sorted and duplicates summed") {
+        dsa::Vector<dsa::Triplet<TestType>> t;
+        t.push_back({2, 3, 5});
+        t.push_back({0, 1, 1});
+        t.push_back({2, 0, 4});
+        t.push_back({0, 1, 2});
+        for (SparseLayout layout : {SparseLayout::csr, SparseLayout::csc}) {
+            Sparse s(3, 4, t, layout);
+            REQUIRE(s.layout() == layout);
+            REQUIRE(s.nonzeros() == 3);
+            REQUIRE(s.at(0, 1) == 3);
+            REQUIRE(s.at(2, 0) == 4);
+            REQUIRE(s.at(2, 3) == 5);
+            REQUIRE(s.at(1, 1) == 0);
+            REQUIRE_THROWS_AS(s.at(3, 0), std::out_of_range);
+        }
+        Sparse s(3, 4, t);
+        REQUIRE(s.offsets().size() == 4);
+        REQUIRE(s.offsets()[1] == 1);
+        REQUIRE(s.indices()[1] == 0);
+        REQUIRE(s.indices()[2] == 3);
+    }
+
+    SECTION("bad shapes and indices throw") {
+        dsa::Vector<dsa::Triplet<TestType>> t;
+        t.push_back({0, 4, 1});
+        REQUIRE_THROWS_AS(Sparse(3, 4, t), std::out_of_range);
+        REQUIRE_THROWS_AS(Sparse(-1, 4), std::out_of_range);
+        Sparse a(3, 4);
+        Sparse b(4, 3);
+        REQUIRE(a.nonzeros() == 0);
+        REQUIRE_THROWS_AS(a + b, std::out_of_range);
+        REQUIRE_THROWS_AS(a * a, std::out_of_range);
+        REQUIRE_THROWS_AS(a * dsa::Matrix<TestType>(3, 3), std::out_of_range);
+        REQUIRE_THROWS_AS(dsa::Matrix<TestType>(3, 4) * a, std::out_of_range);
+        dsa::Vector<TestType> x;
+        x.push_back(1);
+        REQUIRE_THROWS_AS(a * x, std::out_of_range);
+    }
+
+    SECTION("conversions round trip") {
+        auto t = random_triplets(17, 23, 7);
+        dsa::Matrix<TestType> d = dense_of(17, 23, t);
+        Sparse csr(17, 23, t);
+        Sparse csc = csr.to_csc();
+        REQUIRE(csc.layout() == SparseLayout::csc);
+        REQUIRE(equal(csr.to_dense(), d));
+        REQUIRE(equal(csc.to_dense(), d));
+        REQUIRE(equal(csc.to_csr().to_dense(), d));
+        Sparse back = Sparse::from_dense(d, SparseLayout::csc);
+        REQUIRE(back.nonzeros() == Sparse::from_dense(d).nonzeros());
+        REQUIRE(equal(back.to_dense(), d));
+    }
+
+    SECTION("arithmetic matches the dense result") {
+        auto ta = random_triplets(19, 11, 3);
+        auto tb = random_triplets(11, 14, 5);
+        auto tc = random_triplets(19, 11, 9);
+        dsa::Matrix<TestType> da = dense_of(19, 11, ta);
+        dsa::Matrix<TestType> db = dense_of(11, 14, tb);
+        dsa::Matrix<TestType> dc = dense_of(19, 11, tc);
+        dsa::Matrix<TestType> sum = da + dc;
+        dsa::Matrix<TestType> product = da * db;
+        for (SparseLayout la : {SparseLayout::csr, SparseLayout::csc}) {
+            for (SparseLayout lb : {SparseLayout::csr, SparseLayout::csc}) {
+                Sparse a(19, 11, ta, la);
+                Sparse b(11, 14, tb, lb);
+                Sparse c(19, 11, tc, lb);
+                Sparse s = a + c;
+                REQUIRE(s.layout() == la);
+                REQUIRE(equal(s.to_dense(), sum));
+                REQUIRE(equal(a + dc, sum));
+                REQUIRE(equal(dc + a, sum));
+                Sparse p = a * b;
+                REQUIRE(p.layout() == la);
+                REQUIRE(equal(p.to_dense(), product));
+                REQUIRE(equal(a * db, product));
+                REQUIRE(equal(da * b, product));
+            }
+        }
+    }
+
+    SECTION("spmv, serial and on the pool") {
+        // one very dense row among sparse ones
+        auto t = random_triplets(300, 200, 11);
+        for (int j = 0; j < 200; j++) {
+            t.push_back({42, j, 1});
+        }
+        dsa::Matrix<TestType> d = dense_of(300, 200, t);
+        dsa::Vector<TestType> x;
+        for (int j = 0; j < 200; j++) {
+            x.push_back(static_cast<TestType>(j % 7 - 3));
+        }
+        dsa::Vector<TestType> expected;
+        for (int i = 0; i < 300; i++) {
+            TestType sum = 0;
+            for (int j = 0; j < 200; j++) {
+                sum += d(i, j) * x[j];
+            }
+            expected.push_back(sum);
+        }
+        for (unsigned threads : {1u, 3u}) {
+            dsa::parallel::set_threads(threads);
+            dsa::parallel::set_grain(16);
+            for (SparseLayout layout : {SparseLayout::csr, SparseLayout::csc}) {
+                dsa::Vector<TestType> y = Sparse(300, 200, t, layout) * x;
+                REQUIRE(y.size() == 300);
+                for (int i = 0; i < 300; i++) {
+                    REQUIRE(y[i] == expected[i]);
+                }
+            }
+        }
+        dsa::parallel::set_grain(std::size_t(1) << 16);
+        dsa::parallel::set_threads(0);
+    }
+}
+
+TEMPLATE_TEST_CASE("Vector instrumentation counters", "[vector][stats]",
+                   dsa::Vector<int>, dsa::pmr::Vector<int>) {
+    if constexpr (!dsa::vector_stats_enabled) {
+        // compiled out: no extra state, nothing counted
+        REQUIRE(std::is_empty_v<dsa::detail::VectorCounters<>>);
+        TestType v;
+        v.push_back(1);
+        REQUIRE(v.stats().allocations == 0);
+        REQUIRE(dsa::vector_stats().allocations == 0);
+    } else {
+        dsa::reset_vector_stats();
+        TestType v;
+        for (int i = 0; i < 8; i++) {
+            v.push_back(i);
+        }
+        // capacities 1, 2, 4, 8
+        dsa::VectorStats s = v.stats();
+        REQUIRE(s.allocations == 4);
+        REQUIRE(s.bytes_allocated == 15 * sizeof(int));
+        REQUIRE(s.reallocations == 3);
+        REQUIRE(s.moves == 1 + 2 + 4);
+        REQUIRE(s.copies == 8);  // push_back(i) copies i
+        REQUIRE(s.peak_capacity == 8);
+
+        v.reserve(100);
+        v.reserve(50); // no-op
+        TestType w(v);
+        v.shrink_to_fit();
+        s = v.stats();
+        REQUIRE(s.allocations == 6);
+        REQUIRE(s.reallocations == 5);
+        REQUIRE(s.shrinks == 1);
+        REQUIRE(s.moves == 7 + 8 + 8);
+        REQUIRE(s.peak_capacity == 100);
+        REQUIRE(w.stats().allocations == 1);
+        REQUIRE(w.stats().copies == 8);
+
+        dsa::VectorStats g = dsa::vector_stats();
+        REQUIRE(g.allocations == 7);
+        REQUIRE(g.copies == 16);
+        REQUIRE(g.peak_capacity == 100);
+        dsa::reset_vector_stats();
+        REQUIRE(dsa::vector_stats().allocations == 0);
+        REQUIRE(v.stats().allocations == 6);
+
+        // single-element copies count one each; moves and construction
+        // from other arguments do not
+        TestType c;
+        int x = 5;
+        c.push_back(x);
+        REQUIRE(c.stats().copies == 1);
+        c.push_back(std::move(x));
+        c.emplace_back(7);
+        REQUIRE(c.stats().copies == 1);
+        c.emplace_back(x);
+        c.insert(0, x);
+        c.insert(c.begin(), c[1]);
+        REQUIRE(c.stats().copies == 4);
+
+        dsa::Vector<std::string> strings;
+        std::string str = "copied";
+        strings.push_back(str);
+        strings.emplace_back(3, 'a');
+        strings.push_back(std::string("moved"));
+        REQUIRE(strings.stats().copies == 1);
+
+        // an rvalue push moves one element; shifting the tail moves
+        // each element behind the insert or erase point once
+        TestType m;
+        m.reserve(16);
+        for (int i = 0; i < 8; i++) {
+            m.push_back(i);
+        }
+        REQUIRE(m.stats().moves == 0);
+        m.push_back(std::move(x));
+        REQUIRE(m.stats().moves == 1);
+        m.insert(4, x);
+        REQUIRE(m.stats().moves == 1 + 5);
+        int block[] = {1, 2};
+        m.insert(2, std::begin(block), std::end(block));
+        REQUIRE(m.stats().moves == 1 + 5 + 8);
+        m.erase(0);
+        REQUIRE(m.stats().moves == 1 + 5 + 8 + 11);
+        m.erase(9, 11);
+        REQUIRE(m.stats().moves == 1 + 5 + 8 + 11 + 0);
+        m.erase_if([](int e) { return e == 1; });  // the two 1s in front, 7 move
+        REQUIRE(m.stats().moves == 1 + 5 + 8 + 11 + 7);
+        m.remove_indices({5});
+        REQUIRE(m.stats().moves == 1 + 5 + 8 + 11 + 7 + 1);
+        REQUIRE(m.size() == 6);
+
+        dsa::Vector<std::string> shifted;
+        shifted.reserve(8);
+        for (const char* e : {"a", "b", "c"}) {
+            shifted.emplace_back(e);
+        }
+        shifted.insert(0, str);
+        shifted.erase(1);
+        REQUIRE(shifted.stats().moves == 3 + 2);
+    }
+}
+
+TEST_CASE("Vector bulk insert, append and assign", "[vector]") {
+    auto contents = [](const auto& v) {
+        using E = typename std::remove_cvref_t<decltype(v)>::value_type;
+        return std::vector<E>(v.begin(), v.end());
+    };
+
+    SECTION("initializer lists") {
+        dsa::Vector<int> v{1, 2, 3};
+        REQUIRE(contents(v) == std::vector<int>{1, 2, 3});
+        REQUIRE(v.capacity() == 3);
+        v = {4, 5};
+        REQUIRE(contents(v) == std::vector<int>{4, 5});
+        dsa::SmallVector<std::string, 4> sv{"a", "b"};
+        REQUIRE(sv.is_small());
+        REQUIRE(sv.size() == 2);
+        REQUIRE(sv[1] == "b");
+    }
+
+    SECTION("range insert at the front, middle and back") {
+        const std::vector<int> src{7, 8, 9};
+        for (std::size_t pos : {0u, 2u, 5u}) {
+            for (bool roomy : {false, true}) {
+                dsa::Vector<int> v{0, 1, 2, 3, 4};
+                if (roomy) {
+                    v.reserve(16);
+                }
+                std::vector<int> expected{0, 1, 2, 3, 4};
+                expected.insert(expected.begin() + pos, src.begin(), src.end());
+                auto it = v.insert(v.begin() + pos, src.begin(), src.end());
+                REQUIRE(*it == 7);
+                REQUIRE(contents(v) == expected);
+            }
+        }
+        dsa::Vector<int> v{1};
+        REQUIRE_THROWS_AS(v.insert(2, src.begin(), src.end()), std::out_of_range);
+    }
+
+    SECTION("non-trivial elements, with and without reallocation") {
+        const std::list<std::string> src{"x", "y", "z", "w"};
+        for (std::size_t pos : {0u, 1u, 3u}) {
+            for (bool roomy : {false, true}) {
+                dsa::Vector<std::string> v{"a", "b", "c"};
+                if (roomy) {
+                    v.reserve(16);
+                }
+                std::vector<std::string> expected{"a", "b", "c"};
+                expected.insert(expected.begin() + pos, src.begin(), src.end());
+                v.insert(pos, src.begin(), src.end());
+                REQUIRE(contents(v) == expected);
+            }
+        }
+    }
+
+    SECTION("count copies, even of one of our own elements") {
+        dsa::Vector<std::string> v{"a", "b"};
+        v.insert(1, 3, v[0]);
+        REQUIRE(contents(v) == std::vector<std::string>{"a", "a", "a", "a", "b"});
+        v.insert(v.end(), 2, "z");
+        REQUIRE(v.size() == 7);
+        REQUIRE(v[6] == "z");
+        v.assign(2, v[4]);
+        REQUIRE(contents(v) == std::vector<std::string>{"b", "b"});
+    }
+
+    SECTION("single-pass input iterators") {
+        std::istringstream in("4 5 6");
+        dsa::Vector<int> v{1, 9};
+        v.insert(1, std::istream_iterator<int>(in), std::istream_iterator<int>());
+        REQUIRE(contents(v) == std::vector<int>{1, 4, 5, 6, 9});
+        std::istringstream more("7 8");
+        v.append(std::istream_iterator<int>(more), std::istream_iterator<int>());
+        REQUIRE(v.size() == 7);
+        REQUIRE(v.back() == 8);
+        std::istringstream again("3");
+        v.assign(std::istream_iterator<int>(again), std::istream_iterator<int>());
+        REQUIRE(contents(v) == std::vector<int>{3});
+    }
+
+    SECTION("one allocation per bulk operation") {
+        CountingResource res;
+        std::vector<int> src(1000);
+        std::iota(src.begin(), src.end(), 0);
+        dsa::pmr::Vector<int> v(&res);
+        v.append(src.begin(), src.end());
+        REQUIRE(res.allocations == 1);
+        REQUIRE(v.capacity() == 1000);
+        v.insert(500, src.begin(), src.begin() + 10);
+        REQUIRE(res.allocations == 2);
+        REQUIRE(v.size() == 1010);
+        REQUIRE(v[500] == 0);
+        REQUIRE(v[510] == 500);
+        // growth policy capacity, so the next small block fits without one
+        v.append(src.begin(), src.begin() + 10);
+        REQUIRE(res.allocations == 2);
+        v.assign(src.begin(), src.begin() + 5);
+        REQUIRE(res.allocations == 2);
+        REQUIRE(v.size() == 5);
+        REQUIRE(v[4] == 4);
+    }
+
+    SECTION("a throwing copy leaves the vector unchanged") {
+        struct Fussy {
+            int value;
+            Fussy(int v) : value(v) {}
+            Fussy(const Fussy& other) : value(other.value) {
+                if (value < 0) {
+                    throw std::runtime_error("copy");
+                }
+            }
+            Fussy& operator=(const Fussy&) = default;
+        };
+        dsa::Vector<Fussy> v;
+        v.reserve(8);
+        for (int i = 0; i < 3; i++) {
+            v.push_back(Fussy(i));
+        }
+        std::vector<Fussy> bad;
+        bad.reserve(2);
+        bad.emplace_back(5);
+        bad.emplace_back(-1);
+        // in place, then through a reallocation
+        REQUIRE_THROWS_AS(v.insert(1, bad.begin(), bad.end()), std::runtime_error);
+        REQUIRE(v.size() == 3);
+        REQUIRE(v[1].value == 1);
+        std::vector<Fussy> many(10, Fussy(7));
+        many.emplace_back(-1);
+        REQUIRE_THROWS_AS(v.insert(1, many.begin(), many.end()), std::runtime_error);
+        REQUIRE(v.size() == 3);
+        REQUIRE(v.capacity() == 8);
+        REQUIRE(v[2].value == 2);
+    }
+}
+
+TEST_CASE("Vector range erase, erase_if and remove_indices", "[vector]") {
+    auto contents = [](const auto& v) {
+        using E = typename std::remove_cvref_t<decltype(v)>::value_type;
+        return std::vector<E>(v.begin(), v.end());
+    };
+
+    SECTION("erase a range of indices or iterators") {
+        dsa::Vector<int> v{0, 1, 2, 3, 4, 5, 6};
+        v.erase(1, 3);
+        REQUIRE(contents(v) == std::vector<int>{0, 3, 4, 5, 6});
+        auto it = v.erase(v.begin() + 3, v.end());
+        REQUIRE(it == v.end());
+        REQUIRE(contents(v) == std::vector<int>{0, 3, 4});
+        v.erase(1, 1);
+        REQUIRE(v.size() == 3);
+        REQUIRE_THROWS_AS(v.erase(2, 4), std::out_of_range);
+        REQUIRE_THROWS_AS(v.erase(2, 1), std::out_of_range);
+
+        dsa::Vector<std::string> s{"a", "b", "c", "d"};
+        s.erase(0, 2);
+        REQUIRE(contents(s) == std::vector<std::string>{"c", "d"});
+    }
+
+    SECTION("erase_if keeps the order of the survivors") {
+        dsa::Vector<std::string> v{"keep1", "x", "keep2", "x", "x", "keep3"};
+        REQUIRE(v.erase_if([](const std::string& e) { return e == "x"; }) == 3);
+        REQUIRE(contents(v) == std::vector<std::string>{"keep1", "keep2", "keep3"});
+        REQUIRE(v.erase_if([](const std::string&) { return false; }) == 0);
+        REQUIRE(v.size() == 3);
+    }
+
+    SECTION("remove_indices in one pass") {
+        std::vector<int> all(20);
+        std::iota(all.begin(), all.end(), 0);
+        dsa::Vector<int> v;
+        v.append(all.begin(), all.end());
+        std::vector<int> gone{0, 3, 4, 4, 10, 19};
+        REQUIRE(v.remove_indices(gone) == 5);
+        std::vector<int> expected;
+        for (int x : all) {
+            if (std::find(gone.begin(), gone.end(), x) == gone.end()) {
+                expected.push_back(x);
+            }
+        }
+        REQUIRE(contents(v) == expected);
+
+        dsa::Vector<std::string> s{"a", "b", "c", "d", "e"};
+        REQUIRE(s.remove_indices({1, 3}) == 2);
+        REQUIRE(contents(s) == std::vector<std::string>{"a", "c", "e"});
+        REQUIRE(s.remove_indices(std::vector<int>{}) == 0);
+
+        // checked before anything moves
+        REQUIRE_THROWS_AS(s.remove_indices({2, 0}), std::invalid_argument);
+        REQUIRE_THROWS_AS(s.remove_indices({0, 3}), std::out_of_range);
+        REQUIRE_THROWS_AS(s.remove_indices(std::vector<int>{-1}), std::out_of_range);
+        REQUIRE(contents(s) == std::vector<std::string>{"a", "c", "e"});
+    }
+
+    SECTION("at most one shrink per call") {
+        CountingResource res;
+        dsa::pmr::Vector<int> v(&res);
+        for (int i = 0; i < 1024; i++) {
+            v.push_back(i);
+        }
+        int before = res.allocations;
+        REQUIRE(v.erase_if([](int x) { return x % 16 != 0; }) == 960);
+        REQUIRE(res.allocations == before + 1);
+        REQUIRE(v.capacity() == 512);
+        REQUIRE(v[3] == 48);
+
+        std::vector<std::size_t> odd;
+        for (std::size_t i = 1; i < 64; i += 2) {
+            odd.push_back(i);
+        }
+        before = res.allocations;
+        v.remove_indices(odd);
+        v.erase(0, 16);
+        REQUIRE(v.size() == 16);
+        REQUIRE(v[0] == 32 * 16);
+        REQUIRE(res.allocations == before + 2);
+    }
+}
+
+template <typename V>
+concept ResizableUninitialized = requires(V v) { v.resize_uninitialized(1); };
+
+TEST_CASE("Vector resize, zero-filled and uninitialized", "[vector]") {
+    auto contents = [](const auto& v) {
+        return std::vector<typename std::decay_t<decltype(v)>::value_type>(v.begin(), v.end());
+    };
+
+    SECTION("resize(n) value-initializes and truncates") {
+        dsa::Vector<int> v;
+        v.resize(5);
+        REQUIRE(contents(v) == std::vector<int>{0, 0, 0, 0, 0});
+        v[4] = 7;
+        v.resize(8);
+        REQUIRE(contents(v) == std::vector<int>{0, 0, 0, 0, 7, 0, 0, 0});
+        v.resize(2);
+        REQUIRE(contents(v) == std::vector<int>{0, 0});
+        v.resize(2);
+        REQUIRE(v.size() == 2);
+
+        dsa::Vector<double*> p;
+        p.resize(3);
+        REQUIRE(std::all_of(p.begin(), p.end(), [](double* x) { return x == nullptr; }));
+
+        dsa::Vector<std::string> s{"a", "b"};
+        s.resize(4);
+        REQUIRE(contents(s) == std::vector<std::string>{"a", "b", "", ""});
+        s.resize(1);
+        REQUIRE(contents(s) == std::vector<std::string>{"a"});
+    }
+
+    SECTION("zeroed memory after earlier contents") {
+        // the buffer comes back zeroed even where old elements lived
+        dsa::Vector<long> v;
+        for (long i = 1; i <= 100; i++) {
+            v.push_back(i);
+        }
+        v.resize(0);
+        v.resize(1000);
+        REQUIRE(std::all_of(v.begin(), v.end(), [](long x) { return x == 0; }));
+
+        dsa::SmallVector<int, 8> small;
+        small.push_back(9);
+        small.pop_back();
+        small.resize(6);
+        REQUIRE(contents(small) == std::vector<int>{0, 0, 0, 0, 0, 0});
+    }
+
+    SECTION("a large zero buffer is mapped, not written") {
+        std::size_t n = (std::size_t(64) << 20) / sizeof(int) + 1;
+        dsa::Vector<int> v;
+        v.resize(n);
+        REQUIRE(v.size() == n);
+        REQUIRE(v[0] == 0);
+        REQUIRE(v[n / 2] == 0);
+        REQUIRE(v.back() == 0);
+    }
+
+    SECTION("resize(n, value) copies value, which may be an element") {
+        dsa::Vector<std::string> v{"x", "y"};
+        v.resize(5, v[1]);
+        REQUIRE(contents(v) == std::vector<std::string>{"x", "y", "y", "y", "y"});
+        v.resize(2, "z");
+        REQUIRE(contents(v) == std::vector<std::string>{"x", "y"});
+    }
+
+    SECTION("resize_uninitialized keeps the prefix") {
+        dsa::Vector<float> v{1.0f, 2.0f};
+        v.resize_uninitialized(6);
+        REQUIRE(v.size() == 6);
+        REQUIRE(v[0] == 1.0f);
+        REQUIRE(v[1] == 2.0f);
+        for (std::size_t i = 2; i < 6; i++) {
+            v[i] = static_cast<float>(i);
+        }
+        v.resize_uninitialized(3);
+        REQUIRE(contents(v) == std::vector<float>{1.0f, 2.0f, 2.0f});
+        STATIC_REQUIRE(ResizableUninitialized<dsa::Vector<float>>);
+        STATIC_REQUIRE_FALSE(ResizableUninitialized<dsa::Vector<std::string>>);
+    }
+
+    SECTION("one allocation from an arena") {
+        CountingResource res;
+        dsa::pmr::Vector<int> v(&res);
+        v.resize(1000);
+        REQUIRE(res.allocations == 1);
+        REQUIRE(v.capacity() == 1000);
+        REQUIRE(std::all_of(v.begin(), v.end(), [](int x) { return x == 0; }));
+        v.resize_uninitialized(1500);
+        REQUIRE(res.allocations == 2);
+        v.resize(100);
+        REQUIRE(v.capacity() < 1500);
+        REQUIRE(std::all_of(v.begin(), v.end(), [](int x) { return x == 0; }));
+    }
+
+#if defined(__linux__)
+    SECTION("a large zero Matrix is backed lazily") {
+        auto page_faults = [] {
+            rusage usage{};
+            getrusage(RUSAGE_SELF, &usage);
+            return usage.ru_minflt;
+        };
+        long before = page_faults();
+        dsa::Matrix<float> m(4096, 4096);  // 64 MiB of zeros
+        long after = page_faults();
+        REQUIRE(after - before < 256);     // a memset would fault in 16384 pages
+        REQUIRE(m(0, 0) == 0.0f);
+        REQUIRE(m(4095, 4095) == 0.0f);
+        m(2048, 7) = 1.5f;
+        dsa::Matrix<float> copy = m;
+        REQUIRE(copy(2048, 7) == 1.5f);
+        REQUIRE(copy(2048, 8) == 0.0f);
+        m = dsa::Matrix<float>(2, 2);
+        REQUIRE(m(1, 1) == 0.0f);
+    }
+#endif
+
+    SECTION("Matrix results skip the zeroing but are complete") {
+        dsa::Matrix<int> z(3, 4);
+        REQUIRE(std::all_of(z.data(), z.data() + 12, [](int x) { return x == 0; }));
+
+        dsa::Matrix<int> a(2, 3);
+        for (int i = 0; i < 2; i++) {
+            for (int j = 0; j < 3; j++) {
+                a(i, j) = i * 3 + j + 1;
+            }
+        }
+        dsa::Matrix<int> t = a.transpose();
+        REQUIRE(t(2, 1) == 6);
+        dsa::Matrix<int> p = a * t;
+        REQUIRE(p(0, 0) == 14);
+        REQUIRE(p(1, 1) == 77);
+        REQUIRE(p(0, 1) == 32);
+        dsa::Matrix<int> s = a + a;
+        REQUIRE(s(1, 2) == 12);
+        s = t * 2;
+        REQUIRE(s.rows() == 3);
+        REQUIRE(s(2, 0) == 6);
+    }
+}